@@ -0,0 +1,76 @@
+#pragma once
+#include "DataStructs.hpp"
+#include "Input.hpp"
+#include "Snake.hpp"
+#include "Food.hpp"
+#include "OccupancyGrid.hpp"
+#include "Rng.hpp"
+#include "GameManager.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+/*
+Steps many independent arenas of the same size at once, for bot evaluation and soak runs.
+Each kind of per-arena object (generator, grid, snake, food, state, manager) sits in its own vector,
+indexed by arena id. Every arena goes through the very same GameManager::update() as single-game play,
+so results match it exactly. Arenas are split into contiguous ranges, one per worker thread.
+Each arena owns its generator. Like a single game session, every game starts by reseeding it: game g of
+arena i plays with seed + i + g * count, so no two games share a seed and results do not depend on the
+thread count.
+*/
+class BatchEngine {
+	private:
+		int										_width;
+		int										_height;
+		int										_count;
+		uint64_t								_seed;
+
+		std::vector<Rng>						_rngs;
+		std::vector<OccupancyGrid>				_occupancy;
+		std::vector<Snake>						_snakes;
+		std::vector<Food>						_foods;
+		std::vector<GameState>					_states;
+		std::vector<std::unique_ptr<GameManager>>	_managers;
+		std::vector<uint8_t>					_alive;
+		std::vector<long>						_ticks;
+		std::vector<long>						_games;		// games started per arena, the first included
+
+		// Worker pool: stepAll() bumps _generation and every worker steps its own range once
+		std::vector<std::thread>				_workers;
+		std::mutex								_mutex;
+		std::condition_variable					_wake;
+		std::condition_variable					_done;
+		long									_generation;
+		int										_pending;
+		bool									_stopping;
+		std::span<const Input>					_actions;
+
+		void workerLoop(int worker, int workerCount);
+		void stepRange(int begin, int end);
+		void rangeFor(int worker, int workerCount, int &begin, int &end) const;
+
+	public:
+		BatchEngine(int width, int height, int count, int threads, uint64_t seed);
+
+		BatchEngine(const BatchEngine &other) = delete;
+		BatchEngine &operator=(const BatchEngine &other) = delete;
+
+		~BatchEngine();
+
+		// actions[i] is the input for arena i this tick (Input::None keeps the current direction).
+		// Arenas that died stay frozen until resetArena() is called on them.
+		// Steps nothing and returns false when there are fewer actions than arenas.
+		bool stepAll(std::span<const Input> actions);
+		void resetArena(int arena);
+
+		int getCount() const;
+		bool isAlive(int arena) const;
+		int getScore(int arena) const;
+		long getTicks(int arena) const;
+		const GameState &getState(int arena) const;
+};
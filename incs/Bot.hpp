@@ -0,0 +1,12 @@
+#pragma once
+#include "DataStructs.hpp"
+#include "Input.hpp"
+
+// The wandering bot: drives the headless runs and the computer-controlled snakes of a crowded arena.
+// All its randomness comes from the rng it is handed, so a seed replays its every turn.
+class Bot {
+	public:
+		// Pick a direction whose next cell is free, preferring ones that get closer to target most of the time.
+		// Input::None when every way out is blocked.
+		static Input steer(const Snake &snake, Vec2 target, const OccupancyGrid &occupancy, Rng &rng);
+};
@@ -0,0 +1,28 @@
+#pragma once
+#include "DataStructs.hpp"
+#include <cstddef>
+
+enum class SimdLevel {
+	Scalar,
+	Sse2,
+	Avx2
+};
+
+/*
+Bulk loops over packed cells. Each has a scalar version and, on x86-64, SSE2 and AVX2 versions;
+the best one the CPU supports is picked on first use. setLevel() can force a lower level (it is
+clamped to what the CPU supports), which the benchmark uses to compare them.
+*/
+class CellKernels {
+	public:
+		// Index of the first cell equal to target, or count when there is none
+		static size_t find(const Cell *cells, size_t count, Cell target);
+
+		// Vec2 -> Cell for whole runs; coordinates must fit a Cell (see MAX_ARENA_SIDE)
+		static void pack(const Vec2 *in, size_t count, Cell *out);
+
+		static SimdLevel getLevel();
+		static SimdLevel getSupportedLevel();
+		static void setLevel(SimdLevel level);
+		static const char *getLevelName(SimdLevel level);
+};
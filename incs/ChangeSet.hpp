@@ -0,0 +1,52 @@
+#pragma once
+#include "DataStructs.hpp"
+
+/*
+What the ticks since the last frame changed, so a backend that keeps its picture between frames can
+repaint only those cells. GameManager fills it in update() and restore(); the main loop hands it to
+the backend before render() and clears it afterwards.
+The lists name cells to look at again rather than what to paint there: within one frame a cell can
+be taken and freed again, so backends repaint listed cells from the current GameState. fullRedraw
+means the lists can't be trusted (a new game, an unrelated snapshot, more changes than fit) and the
+whole arena has to be drawn again.
+*/
+struct ChangeSet {
+	static const int	MAX_CELLS = 64;
+
+	Cell	added[MAX_CELLS];		// cells a head moved into
+	int		addedCount;
+	Cell	freed[MAX_CELLS];		// cells a tail left
+	int		freedCount;
+	bool	foodMoved;
+	Cell	previousFood;			// where the food sat when the frame started
+	bool	scoreChanged;
+	bool	fullRedraw;
+
+	void clear() {
+		addedCount = 0;
+		freedCount = 0;
+		foodMoved = false;
+		scoreChanged = false;
+		fullRedraw = false;
+	}
+
+	void addCell(Cell cell) {
+		if (addedCount < MAX_CELLS)
+			added[addedCount++] = cell;
+		else
+			fullRedraw = true;
+	}
+
+	void freeCell(Cell cell) {
+		if (freedCount < MAX_CELLS)
+			freed[freedCount++] = cell;
+		else
+			fullRedraw = true;
+	}
+
+	void moveFood(Cell from) {
+		if (!foodMoved)
+			previousFood = from;
+		foodMoved = true;
+	}
+};
@@ -1,13 +1,39 @@
 #pragma once
 #include <cstddef>
+#include <cstdint>
+#include <span>
 
 struct Vec2 {
 	int	x;
 	int	y;
 };
 
+/*
+A grid cell packed into 32 bits, x in the low half and y in the high half, both as signed 16-bit
+values so a head that just left the arena (-1) still round-trips. Equality is a single compare and
+a long body takes half the memory of Vec2; renderers and input code keep working in Vec2.
+*/
+using Cell = uint32_t;
+
+// Largest arena side whose cells (plus the one step past the wall) fit a Cell
+constexpr int MAX_ARENA_SIDE = 32767;
+
+// Snakes (the player included) and foods one arena takes, well inside what the occupancy grid's owner layer can tell apart
+constexpr int MAX_SNAKES = 1024;
+constexpr int MAX_FOODS = 1024;
+
+inline Cell packCell(Vec2 cell) {
+	return static_cast<uint16_t>(cell.x) | (static_cast<uint32_t>(static_cast<uint16_t>(cell.y)) << 16);
+}
+
+inline Vec2 unpackCell(Cell cell) {
+	return Vec2{ static_cast<int16_t>(cell & 0xFFFF), static_cast<int16_t>(cell >> 16) };
+}
+
 class Snake;
 class Food;
+class OccupancyGrid;
+class Rng;
 
 enum class GameStateType {
     Menu,
@@ -21,9 +47,15 @@ struct GameState {
 	int				height;
 	Snake&			snake;
 	Food&			food;
+	OccupancyGrid&	occupancy;
+	Rng&			rng;
 	bool			gameOver;
 	bool			isRunning;
 	bool			isPaused;
 	GameStateType	currentState;
-	int				score;
+	int				score;			// the player's
+	// Everything in the arena, index = owner id on the grid: snakes[0] is snake (the player), foods[0] is food.
+	// A plain game is one of each; more make it a crowded arena, see GameManager::populate()
+	std::span<Snake>	snakes;
+	std::span<Food>		foods;
 };
@@ -1,23 +1,26 @@
 #pragma once
 #include "DataStructs.hpp"
 #include "Utils.hpp"
+#include "Rng.hpp"
 
 class Food {
 	private:
-		Vec2		_position;
+		Cell		_position;
 		int			_hLimit;
 		int			_vLimit;
 		const char	*_foodChar;
 
 	public:
 		Food() = delete;
-		Food(Vec2 position, int width, int height);
+		Food(Vec2 position, int width, int height, Rng &rng);
 		
 		Food(const Food &other);
 		Food &operator=(const Food &other);
 
 		bool replaceInFreeSpace(GameState *gameState);
+		void place(Vec2 position, const char *foodChar);
 
 		Vec2 getPosition() const;
+		Cell getCell() const;
 		const char* getFoodChar() const;
 };
\ No newline at end of file
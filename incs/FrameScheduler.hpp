@@ -0,0 +1,27 @@
+#pragma once
+#include "IGraphic.hpp"
+#include <chrono>
+
+/*
+Puts the main loop to sleep until its next real deadline (a tick or a frame) or until the current
+backend has input, whichever comes first. Deadlines are absolute, armed on a timerfd, and polled
+together with the backend's input fd; backends with their own event queue wait through
+IGraphic::waitEvents() instead. Without either, it simply sleeps until the deadline.
+*/
+class FrameScheduler {
+	private:
+		int		_timerFd;
+
+		bool waitOnFd(int inputFd, std::chrono::steady_clock::time_point deadline);
+
+	public:
+		FrameScheduler();
+
+		FrameScheduler(const FrameScheduler &other) = delete;
+		FrameScheduler &operator=(const FrameScheduler &other) = delete;
+
+		~FrameScheduler();
+
+		// True when woken early by input; a signal also ends the wait early
+		bool waitUntil(std::chrono::steady_clock::time_point deadline, IGraphic &graphic);
+};
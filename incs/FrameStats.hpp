@@ -0,0 +1,53 @@
+#pragma once
+#include "LatencyHistogram.hpp"
+#include "TickScheduler.hpp"
+#include <chrono>
+#include <string>
+
+enum class FramePhase {
+	Poll,
+	Update,		// one sample per simulation tick
+	Render,
+	Present,
+	Sleep,
+	Switch,		// one sample per graphics library switch
+	Frame,		// whole loop iteration
+	Count
+};
+
+/*
+Always-on frame timing for the main loop. The loop calls beginFrame(), then lap() after each phase:
+a lap costs one steady_clock read and a histogram increment, so it can stay enabled in normal play.
+When the Tracer is enabled every lap also becomes a trace event named after its phase.
+*/
+class FrameStats {
+	private:
+		using clock = std::chrono::steady_clock;
+
+		LatencyHistogram	_phases[static_cast<int>(FramePhase::Count)];
+		TickCounters		_ticks;
+		clock::time_point	_frameStart;
+		clock::time_point	_lapStart;
+
+		static const char *phaseName(FramePhase phase);
+		bool writeJson(const std::string &path) const;
+		bool writeCsv(const std::string &path) const;
+
+	public:
+		FrameStats();
+
+		void beginFrame();
+		// Time since the previous lap (or beginFrame) goes to phase
+		void lap(FramePhase phase);
+		// Start the next lap now, dropping whatever happened since the last one (e.g. a library switch)
+		void skipLap();
+		void endFrame();
+
+		const LatencyHistogram &get(FramePhase phase) const;
+
+		// Written out next to the phases; whoever schedules ticks keeps these up to date
+		void setTickCounters(const TickCounters &counters);
+
+		// CSV when the path ends in .csv, JSON otherwise
+		bool write(const std::string &path) const;
+};
@@ -4,19 +4,43 @@
 #include "Snake.hpp"
 #include "Food.hpp"
 #include "Utils.hpp"
+#include "Replay.hpp"
+#include "GameSnapshot.hpp"
+#include "SpscQueue.hpp"
+#include "ChangeSet.hpp"
 #include <iostream>
 #include <chrono>
-#include <queue>
+#include <vector>
 
 class GameManager {
 	private:
 		GameState*			_state;
-		std::queue<Input>	inputBuffer;
-		static const size_t	MAX_BUFFER_SIZE = 3;
+		static const int	MAX_BUFFER_SIZE = GameSnapshot::MAX_INPUTS;
+		static const size_t	INPUT_QUEUE_SIZE = 16;
+
+		// Inputs as they arrive, possibly from another thread; ticks move them into the turn buffer below
+		SpscQueue<TimedInput, INPUT_QUEUE_SIZE>	_arrivals;
+
+		// Fixed ring of turns waiting for a tick, oldest at _inputHead
+		Input				_inputBuffer[MAX_BUFFER_SIZE];
+		int					_inputHead;
+		int					_inputCount;
+		long				_tick;
+		long				_generation;	// bumped by resetTick(), so restore() can tell a later tick from another game
+		ReplayRecorder		*_recorder;
+		ChangeSet			_changes;
+		std::vector<int>	_dying;			// snake ids the current crowded tick kills, kept to avoid reallocating
+
+		// Tries at a food spot no other food holds before settling for a scan of the free cells
+		static const int	FOOD_ATTEMPTS = 8;
 
 		using time = std::chrono::time_point<std::chrono::high_resolution_clock>;
 
+		void takeArrivals(std::chrono::steady_clock::time_point tickTime);
 		void processNextInput();
+		void recordRestoreChanges(const GameSnapshot &snapshot);
+		void updateCrowd();
+		bool placeFood(int index);
 
 	public:
 		GameManager(GameState *state);
@@ -26,9 +50,42 @@ class GameManager {
 
 		~GameManager() = default;
 
+		// Applies every input queued so far
 		void update();
+		// Only applies inputs that arrived by tickTime; later ones wait for the next tick
+		void update(std::chrono::steady_clock::time_point tickTime);
+
+		// More than one snake or food: bots steer themselves, and collisions and pickups go through the
+		// owner layer of the occupancy grid, so a tick costs O(snakes) whatever the food count
+		bool isCrowded() const;
+		// Sets up the snakes and foods of an arena for a GameState: the player and foods[0] draw from rng exactly
+		// as in a plain game, the rest only get their real places from populate(). Both vectors are sized up
+		// front since the state keeps spans over them
+		static void buildArena(int width, int height, int snakeCount, int foodCount, OccupancyGrid &occupancy,
+			Rng &rng, std::vector<Snake> &snakes, std::vector<Food> &foods);
+		// Starts the rest of a crowded arena once the player and foods[0] are set up for a new game:
+		// every bot respawns, every other food gets a free cell. Nothing to do in a plain game
+		void populate();
+
+		// Ticks simulated since the game started; turns are recorded against this
+		long getTick() const;
+		void resetTick();
+		void setRecorder(ReplayRecorder *recorder);
+
+		// Copy the whole simulation state out and back in; neither allocates once the snapshot has warmed up.
+		// Only the player and foods[0] are covered, so crowded arenas don't take snapshots
+		void capture(GameSnapshot &snapshot) const;
+		void restore(const GameSnapshot &snapshot);
+
+		// Cells touched since the last clearChanges(), for backends that only repaint what changed.
+		// Belongs to whichever thread runs update(), like the rest of the state
+		const ChangeSet &getChanges() const;
+		void clearChanges();
+		void markFullRedraw();
 
+		// The only call allowed from a thread other than the one running update(); one such thread at most
 		void bufferInput(Input input);
+		void bufferInput(Input input, std::chrono::steady_clock::time_point time);
 		void clearInputBuffer();
 
 		void checkHeadFoodCollision();
@@ -0,0 +1,31 @@
+#pragma once
+#include "DataStructs.hpp"
+#include "Input.hpp"
+#include "Snake.hpp"
+#include "Rng.hpp"
+#include <vector>
+
+/*
+Everything needed to put a running game back exactly where it was: filled by GameManager::capture()
+and applied by GameManager::restore(). Keep one around and capture into it over and over: the
+segment vector only grows, so once it has held the longest snake no capture allocates again.
+*/
+struct GameSnapshot {
+	static const int	MAX_INPUTS = 3;
+
+	std::vector<Cell>	segments;		// packed, head first
+	Vec2				previousHead;
+	Vec2				previousTail;
+	Direction			direction;
+	int					pendingGrowth;
+	bool				headOnBody;
+	Vec2				foodPosition;
+	const char			*foodChar;
+	int					score;
+	bool				isRunning;
+	long				tick;
+	long				generation;
+	Rng::State			rng;
+	Input				inputs[MAX_INPUTS];	// oldest first
+	int					inputCount;
+};
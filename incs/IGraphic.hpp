@@ -1,19 +1,73 @@
 #pragma once
 #include "DataStructs.hpp"
 #include "Input.hpp"
+#include "ChangeSet.hpp"
+#include <cstdint>
+
+/*
+Every plugin exports a descriptor next to createGraphic(). LibraryManager refuses a plugin whose
+abiVersion differs from the one it was built with, so bump GRAPHIC_ABI_VERSION whenever IGraphic's
+layout or the meaning of a call changes. The capability flags name the optional calls a plugin actually
+implements; the core leaves out the work behind any it doesn't claim. New optional paths get a new flag
+instead of a version bump, so older plugins keep loading.
+*/
+constexpr uint32_t GRAPHIC_ABI_VERSION = 1;
+
+enum GraphicCapability : uint32_t {
+	GRAPHIC_CAP_CHANGES			= 1u << 0,	// repaints from applyChanges(); without it the game stops tracking cells
+	GRAPHIC_CAP_INTERPOLATION	= 1u << 1,	// draws from setInterpolation(); without it the alpha isn't computed
+	GRAPHIC_CAP_PREWARM			= 1u << 2,	// has work in prewarm(); without it only the dlopen() is done ahead
+};
+
+struct GraphicDescriptor {
+	uint32_t	abiVersion;
+	uint32_t	capabilities;
+	const char	*name;
+};
 
 class IGraphic {
 	public:
 		virtual ~IGraphic() = default;
 
 		virtual void init(int width, int height) = 0;
+
+		// The part of init() that needs neither the window system nor the terminal: reading fonts and
+		// logos, building images in memory. LibraryManager may run it on a worker thread ahead of a switch;
+		// init() then skips whatever is already done. It must not touch any global library state
+		virtual void prewarm(int width, int height) { (void)width; (void)height; }
 		virtual void render(const GameState &state, float deltaTime) = 0;
 		virtual void renderMenu(const GameState& state, float deltaTime) = 0;
 		virtual void renderGameOver(const GameState& state, float deltaTime) = 0;
 		virtual Input pollInput() = 0;
+
+		// Show the frame drawn by the last render*() call. Kept apart from drawing so the two can be
+		// timed separately; a backend that can't split them simply draws and presents in render*()
+		virtual void present() {}
+
+		// How far (0 to 1) time has moved from the last tick towards the next one, set before render().
+		// Backends that draw off the grid can slide the head and tail from Snake::getPreviousHead() and
+		// getPreviousTail() by that much; the others just ignore it
+		virtual void setInterpolation(float alpha) { (void)alpha; }
+
+		// What changed since the previous render(), handed over right before it. A backend that keeps
+		// its picture between frames can repaint just those cells; the rest redraw everything anyway
+		virtual void applyChanges(const ChangeSet &changes) { (void)changes; }
+
+		// Lets the main loop sleep until input shows up instead of polling. A backend whose input comes
+		// from a file descriptor returns it here; one with its own event queue implements waitEvents(),
+		// which returns 1 once input is pending, 0 on timeout and -1 when the backend can't wait at all
+		virtual int getInputFd() const { return -1; }
+		virtual int waitEvents(int timeoutMs) { (void)timeoutMs; return -1; }
+
+		// With resident plugins every backend stays initialized and only the active one draws and polls.
+		// suspend() takes it out of sight (hide the window, leave curses mode) and resume() brings it back
+		// ready for the next render*(), dropping any input that queued up in between
+		virtual void suspend() {}
+		virtual void resume() {}
 };
 
 extern "C" {
+	const GraphicDescriptor *getGraphicDescriptor();
 	IGraphic *createGraphic();
 	void destroyGraphic(IGraphic*);
 }
\ No newline at end of file
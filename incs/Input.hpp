@@ -1,4 +1,5 @@
 #pragma once
+#include <chrono>
 
 /*
 Each library will map to this enum:
@@ -19,4 +20,10 @@ enum class Input {
 	Quit,
 	Pause,
 	Enter,
+};
+
+// A key and the moment it was read, so the simulation can hold it back until the tick it arrived in
+struct TimedInput {
+	Input									input;
+	std::chrono::steady_clock::time_point	time;
 };
\ No newline at end of file
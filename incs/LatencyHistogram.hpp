@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+
+/*
+Fixed-size log-linear histogram of durations in nanoseconds (HDR style): each power of two is split
+into 16 linear sub-buckets, so any recorded value is known to within 1/16 (~6%) from 1 ns up to
+centuries. Recording is a couple of bit operations and an increment; nothing is ever allocated.
+*/
+class LatencyHistogram {
+	public:
+		static const int	SUB_BUCKET_BITS = 4;
+		static const int	SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+		static const int	BUCKET_COUNT = (64 - SUB_BUCKET_BITS) * SUB_BUCKETS + SUB_BUCKETS;
+
+	private:
+		uint64_t	_counts[BUCKET_COUNT];
+		uint64_t	_total;
+		uint64_t	_sum;
+		uint64_t	_max;
+
+		static int bucketFor(uint64_t value);
+		static uint64_t bucketUpperBound(int bucket);
+
+	public:
+		LatencyHistogram();
+
+		void record(uint64_t nanoseconds);
+		void reset();
+
+		uint64_t getCount() const;
+		uint64_t getMax() const;
+		double getMean() const;
+		// Upper bound of the bucket holding the given quantile (0.5 for p50, 0.99 for p99), capped at the max
+		uint64_t getPercentile(double quantile) const;
+};
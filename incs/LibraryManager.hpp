@@ -1,14 +1,72 @@
 #pragma once
 #include "IGraphic.hpp"
 #include <dlfcn.h>
+#include <condition_variable>
+#include <deque>
 #include <iostream>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
+/*
+Owns the graphics plugins. By default it holds one at a time: load() opens it and unload() destroys it,
+so every switch pays for dlopen, window or terminal setup and asset loading again. A plugin whose
+descriptor is missing or names another GRAPHIC_ABI_VERSION is refused, and load() then leaves the
+current one in place.
+In resident mode loadResident() opens and initializes every plugin once; switching is then activate(),
+which only suspends the current backend and resumes the next one.
+Without it, prewarm() hands the plugins that aren't loaded to a worker thread, which opens them and runs
+their IGraphic::prewarm() in the background. load() then takes the warm copy and only init() is left
+for the main thread.
+With hot reload on (a development mode), every plugin is opened from its own copy under /tmp, and
+inotify watches the directories the originals live in. reloadIfChanged() swaps a rebuilt active plugin
+for a fresh copy between two frames; a rebuilt warm one is simply warmed again.
+*/
 class LibraryManager {
 	private:
-		void *handle;
-		IGraphic *graphic;
+		struct Plugin {
+			std::string					path;
+			void						*handle;
+			const GraphicDescriptor		*descriptor;
+			IGraphic					*graphic;
+		};
+
+		std::vector<Plugin>	plugins;
+		size_t				active;
+		bool				resident;
+
+		// Pre-warming, all guarded by warmMutex
+		std::thread				warmer;
+		std::mutex				warmMutex;
+		std::condition_variable	warmChanged;
+		std::deque<std::string>	warmQueue;
+		std::string				warming;		// being opened by the worker right now
+		bool					warmingStale;	// rebuilt since the worker opened it, so it goes back in the queue
+		std::vector<Plugin>		warmed;
+		int						warmWidth;
+		int						warmHeight;
+		bool					stopping;
+
+		// Hot reload; the watches are only touched on the main thread
+		bool										hotReload;
+		int											watchFd;
+		std::vector<std::pair<int, std::string>>	watchedDirs;	// inotify watch, directory
+
+		using DescriptorFn = const GraphicDescriptor *(*)();
 		using CreateFn = IGraphic *(*)();
 		using DestroyFn = void (*)(IGraphic*);
+
+		bool open(const char *libPath, Plugin &plugin, std::string &error);
+		void close(Plugin &plugin);
+		void warmLoop();
+		bool takeWarm(const char *libPath, Plugin &plugin);
+		bool copyForReload(const std::string &libPath, std::string &copyPath, std::string &error);
+		void watch(const std::string &libPath);
+		bool isWatched(const std::string &libPath, int wd, const char *name) const;
+		void rewarm(int wd, const char *name);
 	
 	public:
 		LibraryManager();
@@ -21,5 +79,22 @@ class LibraryManager {
 		bool load(const char *libPath);
 		void unload();
 
+		// Queues every plugin in libPaths that isn't loaded or already warm; returns straight away
+		void prewarm(std::span<const std::string_view> libPaths, int width, int height);
+
+		// Opens and initializes every plugin in libPaths; all but first are suspended straight away
+		bool loadResident(std::span<const std::string_view> libPaths, size_t first, int width, int height);
+		// Resident mode only: suspends the active plugin and resumes the one at index
+		void activate(size_t index);
+		bool isResident() const;
+
+		// Call before the first load(); false when inotify isn't available
+		bool enableHotReload();
+		// Swaps the active plugin for a fresh copy when its file was rebuilt since the last call. On true
+		// the new plugin still needs init(); on a failed reload the old one stays
+		bool reloadIfChanged();
+
 		IGraphic *get();
-};
\ No newline at end of file
+		// Whether the active plugin claims capability, one of the GRAPHIC_CAP_ flags
+		bool supports(uint32_t capability) const;
+};
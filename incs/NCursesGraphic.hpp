@@ -24,7 +24,15 @@ private:
 	int		width, height;
 	WINDOW	*gameWindow;
 	bool	isInitialized;
+	bool	isPrewarmed;
+	std::vector<std::string> missingLogos;  // found by prewarm(), which may run on another thread; init() reports them
 	std::vector<std::vector<char>> groundPattern;  // Stores the ground texture
+
+	// The game window keeps its contents between frames, so after one full paint only the cells
+	// named by the change sets (plus every snake's old and new head and its tail, whose glyphs shift) are redrawn
+	bool				fullRedraw;
+	std::vector<Cell>	dirtyCells;
+	std::vector<Vec2>	drawnHeads;		// per snake, as of the last frame
 	
 	// Logo Cache
 	AsciiArtFile titleSmallA, titleSmallB, titleSmallC, titleSmallD;
@@ -39,9 +47,12 @@ private:
 	void drawGameOverScreen(const GameState &state, int win_height, int win_width);
 	void drawGameOverTitle(int win_height, int win_width);
 	void drawGround();
+	void drawGroundCell(int x, int y);
+	void drawCell(const GameState &state, Vec2 cell);
+	const char *snakeGlyph(const Snake &snake, Vec2 cell) const;
 	void drawBorder();
-	void drawSnake(const GameState &state);
-	void drawFood(const GameState &state);
+	void drawSnake(const Snake &snake);
+	void drawFood(const Food &food);
 	void generateGroundPattern();
 	
 	// Logo drawing helper
@@ -54,12 +65,23 @@ public:
 	~NCursesGraphic();
 	
 	void init(int w, int h) override;
+	void prewarm(int w, int h) override;
 	void render(const GameState& state, float deltaTime) override;
 	void renderMenu(const GameState &state, float deltaTime) override;
 	void renderGameOver(const GameState &state, float deltaTime) override;
 	Input pollInput() override;
+	void present() override;
+	void applyChanges(const ChangeSet &changes) override;
+	int getInputFd() const override;
+	void suspend() override;
+	void resume() override;
 };
 
+extern "C" const GraphicDescriptor *getGraphicDescriptor() {
+	static const GraphicDescriptor descriptor = { GRAPHIC_ABI_VERSION, GRAPHIC_CAP_CHANGES | GRAPHIC_CAP_PREWARM, "ncurses" };
+	return &descriptor;
+}
+
 extern "C" IGraphic* createGraphic() {
 	return new NCursesGraphic();
 }
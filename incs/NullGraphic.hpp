@@ -0,0 +1,38 @@
+#pragma once
+#include "IGraphic.hpp"
+#include "colors.h"
+#include <iostream>
+
+// Renderer that draws nothing and never produces input.
+// Used by the headless build and for soak runs on machines without a display.
+class NullGraphic : public IGraphic {
+	private:
+		int		width;
+		int		height;
+		long	framesRendered;
+
+	public:
+		NullGraphic();
+		NullGraphic(const NullGraphic&) = delete;
+		NullGraphic &operator=(const NullGraphic&) = delete;
+		~NullGraphic();
+
+		void init(int w, int h) override;
+		void render(const GameState &state, float deltaTime) override;
+		void renderMenu(const GameState &state, float deltaTime) override;
+		void renderGameOver(const GameState &state, float deltaTime) override;
+		Input pollInput() override;
+};
+
+extern "C" const GraphicDescriptor *getGraphicDescriptor() {
+	static const GraphicDescriptor descriptor = { GRAPHIC_ABI_VERSION, 0, "null" };
+	return &descriptor;
+}
+
+extern "C" IGraphic* createGraphic() {
+	return new NullGraphic();
+}
+
+extern "C" void destroyGraphic(IGraphic* g) {
+	delete g;
+}
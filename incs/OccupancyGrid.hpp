@@ -0,0 +1,88 @@
+#pragma once
+#include "DataStructs.hpp"
+#include "SegmentStore.hpp"
+#include <cstdint>
+#include <vector>
+
+// One bit per arena cell, set while a snake segment sits on it.
+// Kept in sync incrementally by Snake, so "is this cell taken?" never needs a walk over the body.
+// Alongside the bits lives a Fenwick tree of free-cell counts per 64-bit word, so the n-th free cell
+// (in row-major order) is found in O(log cells) without allocating. The order only depends on which
+// cells are taken, never on how they got there, so a restored snapshot places food exactly as the original did.
+// Arenas holding several snakes also switch on an owner layer: which snake holds each cell and which food
+// sits on it, so collisions and food pickups are a lookup at the head instead of a scan over every body.
+class OccupancyGrid {
+	private:
+		int						_width;
+		int						_height;
+		int						_occupied;
+		std::vector<uint64_t>	_bits;
+		std::vector<uint32_t>	_freeTree;	// 1-based Fenwick tree over the free count of each word of _bits
+		int						_treeTop;	// highest power of two <= _bits.size(), where select() starts
+		// Empty until enableOwners(); per cell, snake id + 1 and food index + 1, 0 meaning none
+		std::vector<uint16_t>	_snakeOwners;
+		std::vector<uint16_t>	_foodOwners;
+
+		int index(Vec2 cell) const { return (cell.y * _width) + cell.x; }
+		uint64_t validMask(size_t word) const;
+		void addFree(size_t word, int delta);
+		void rebuildTree();
+
+	public:
+		OccupancyGrid() = delete;
+		OccupancyGrid(int width, int height);
+
+		OccupancyGrid(const OccupancyGrid &other) = default;
+		OccupancyGrid &operator=(const OccupancyGrid &other) = default;
+
+		~OccupancyGrid() = default;
+
+		bool inBounds(Vec2 cell) const {
+			return cell.x >= 0 && cell.x < _width && cell.y >= 0 && cell.y < _height;
+		}
+
+		// Out of bounds cells are reported as not occupied, callers check walls separately
+		bool isOccupied(Vec2 cell) const {
+			if (!inBounds(cell))
+				return false;
+			int idx = index(cell);
+			return (_bits[idx >> 6] >> (idx & 63)) & 1;
+		}
+
+		bool isFree(Vec2 cell) const { return inBounds(cell) && !isOccupied(cell); }
+
+		// owner is the snake id, only kept when the owner layer is on. A taken cell keeps its first owner,
+		// and release() leaves cells owned by another snake alone
+		void occupy(Vec2 cell, int owner = 0);
+		void release(Vec2 cell, int owner = 0);
+		bool testAndOccupy(Vec2 cell, int owner = 0);
+		void clear();
+
+		// Same as calling occupy()/release() on every cell, but long runs flip the bits
+		// directly and rebuild the free counts once instead of updating them cell by cell
+		void occupyAll(const SegmentStore &cells, int owner = 0);
+		void releaseAll(const SegmentStore &cells, int owner = 0);
+
+		// Largest snake id and food index the owner layer can tell apart
+		static const int	MAX_OWNERS = 0xFFFE;
+
+		void enableOwners();
+		bool hasOwners() const { return !_snakeOwners.empty(); }
+		// Snake id or food index on the cell, -1 when there is none (or no owner layer)
+		int getSnakeAt(Vec2 cell) const {
+			return (hasOwners() && inBounds(cell)) ? _snakeOwners[index(cell)] - 1 : -1;
+		}
+		int getFoodAt(Vec2 cell) const {
+			return (hasOwners() && inBounds(cell)) ? _foodOwners[index(cell)] - 1 : -1;
+		}
+		// Food marks don't touch the occupancy bits: a food cell is still free for snakes and spawns
+		void setFoodAt(Vec2 cell, int food);
+
+		int getWidth() const { return _width; }
+		int getHeight() const { return _height; }
+		int getOccupiedCount() const { return _occupied; }
+		int getFreeCount() const { return (_width * _height) - _occupied; }
+
+		// n-th free cell in row-major order, 0 <= n < getFreeCount()
+		Vec2 getFreeCell(int n) const;
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include "IGraphic.hpp"
+#include "Snake.hpp"
+#include "Food.hpp"
+#include "colors.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+Software renderer for machines without a display. It draws the scene SDLGraphic draws (background,
+snakes, food and border, same layout and colours) into an RGBA framebuffer in memory. The effects
+driven by the clock (tunnel lines, particles) are left out, so one GameState and interpolation always
+give the same bytes. Plugins only get the arena size, so the rest comes from the environment:
+	NIBBLER_OFFSCREEN_CELL	pixels per cell, 20 by default (SDL uses 50)
+	NIBBLER_FRAME_DUMP		file or pipe that receives every presented frame as raw RGBA rows
+	NIBBLER_FRAME_HASH		file that receives an FNV-1a hash of every frame, one per line; a digest of all
+							of them is printed on exit
+Dumping and hashing happen on a writer thread. present() hands the framebuffer over and only waits
+when MAX_QUEUED frames are already waiting. On exit it prints frames per second, counting the time
+spent in render*() and present() but not that wait.
+*/
+class OffscreenGraphic : public IGraphic {
+	private:
+		static const size_t	MAX_QUEUED = 4;
+
+		int						gridWidth;
+		int						gridHeight;
+		int						cellSize;
+		int						borderOffset;
+		int						frameWidth;
+		int						frameHeight;
+		std::vector<uint32_t>	pixels;			// RGBA bytes, one word per pixel
+		float					interpolation;
+		bool					isInitialized;
+
+		long										frames;
+		std::chrono::steady_clock::duration			busyTime;
+		std::chrono::steady_clock::time_point		frameStart;
+
+		// Writer thread; sessionHash is only read once it has been joined
+		std::FILE								*dump;
+		std::FILE								*hashes;
+		uint64_t								sessionHash;
+		std::thread								writer;
+		std::mutex								queueMutex;
+		std::condition_variable					queueChanged;
+		std::deque<std::vector<uint32_t>>		queued;
+		std::vector<std::vector<uint32_t>>		spare;
+		size_t									buffers;	// framebuffers handed out so far: the one drawn into, queued or spare
+		bool									stopping;
+
+		void fillRect(int x, int y, int w, int h, uint32_t color);
+		void drawScene(const GameState &state);
+		void drawSnake(const Snake &snake);
+		void drawFood(const Food &food);
+		void drawBorder(int thickness);
+		void writeLoop();
+
+	public:
+		OffscreenGraphic();
+		OffscreenGraphic(const OffscreenGraphic&) = delete;
+		OffscreenGraphic &operator=(const OffscreenGraphic&) = delete;
+		~OffscreenGraphic();
+
+		void init(int width, int height) override;
+		void prewarm(int width, int height) override;
+		void render(const GameState &state, float deltaTime) override;
+		void renderMenu(const GameState &state, float deltaTime) override;
+		void renderGameOver(const GameState &state, float deltaTime) override;
+		Input pollInput() override;
+		void present() override;
+		void setInterpolation(float alpha) override;
+};
+
+extern "C" const GraphicDescriptor *getGraphicDescriptor() {
+	static const GraphicDescriptor descriptor = { GRAPHIC_ABI_VERSION, GRAPHIC_CAP_INTERPOLATION | GRAPHIC_CAP_PREWARM, "offscreen" };
+	return &descriptor;
+}
+
+extern "C" IGraphic* createGraphic() {
+	return new OffscreenGraphic();
+}
+
+extern "C" void destroyGraphic(IGraphic* g) {
+	delete g;
+}
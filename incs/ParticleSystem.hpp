@@ -1,5 +1,6 @@
 #pragma once
 #include <SDL2/SDL.h>
+#include "Rng.hpp"
 #include <vector>
 #include <cmath>
 #include <algorithm>
@@ -25,17 +26,18 @@ struct Particle {
 	SDL_Color		color;
 	
 	// Constructor for Dust particles
-	Particle(float px, float py, float minSize, float maxSize, float minLifetime, float maxLifetime);
+	Particle(float px, float py, float minSize, float maxSize, float minLifetime, float maxLifetime, Rng &rng);
 	
 	// Constructor for Explosion and Trail particles
 	Particle(float px, float py, float minSize, float maxSize, float minLifetime, float maxLifetime, 
-			float velocityX, float velocityY, SDL_Color particleColor);
+			float velocityX, float velocityY, SDL_Color particleColor, Rng &rng);
 };
 
 class ParticleSystem {
 	private:
 		SDL_Renderer*			renderer;
 		std::vector<Particle>	particles;
+		Rng						rng;	// Cosmetic only, so it takes a fresh seed from std::random_device, apart from the game's generator
 		
 		// Grid dimensions for boundary checking
 		int		gridWidth;
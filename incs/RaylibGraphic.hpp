@@ -16,9 +16,12 @@ private:
 	int		screenHeight;
 
 	float	accumulatedTime;
+	float	interpolation;	// fraction of the current tick elapsed, see IGraphic::setInterpolation()
 
 	Camera3D	camera;
 	Texture2D	grainTexture;  // Pre-generated grain texture
+	Image		grainImage;    // its pixels, generated by prewarm() and uploaded in init()
+	bool		isPrewarmed;
 	
 	// Colors
 	Color customWhite = { 255, 248, 227, 255};      // Warm off-white (cream)
@@ -50,6 +53,14 @@ private:
 	Color snakeDarkFront = { 18, 45, 68, 255 };        // Ground dark blue (darker)
 	Color snakeDarkSide = { 26, 64, 96, 255 };         // Ground blue (lighter than front)
 	Color snakeHidden = customBlack;
+
+	// Bot snake colors - Purple shades (matches the walls)
+	Color botLightTop = { 200, 180, 240, 255 };        // Lavender (brightest)
+	Color botLightFront = { 72, 52, 112, 255 };        // Dark purple
+	Color botLightSide = { 147, 112, 219, 255 };       // Medium purple
+	Color botDarkTop = { 147, 112, 219, 255 };         // Medium purple
+	Color botDarkFront = { 50, 36, 80, 255 };          // Darker purple
+	Color botDarkSide = { 72, 52, 112, 255 };          // Dark purple
 	
 	// Food colors - Red shades (based on ground red)
 	Color foodTop = { 255, 120, 120, 255 };            // Light coral red (brightest)
@@ -75,12 +86,22 @@ public:
 	void DrawOutlinedText(const char *text, int posX, int posY, int fontSize, Color color, int outlineSize, Color outlineColor);
 
 	void init(int width, int height) override;
+	void prewarm(int width, int height) override;
 	void render(const GameState& state, float deltaTime) override;
 	void renderMenu(const GameState &state, float deltaTime) override;
 	void renderGameOver(const GameState &state, float deltaTime) override;
 	Input pollInput() override;
+	void present() override;
+	void suspend() override;
+	void resume() override;
+	void setInterpolation(float alpha) override;
 };
 
+extern "C" const GraphicDescriptor *getGraphicDescriptor() {
+	static const GraphicDescriptor descriptor = { GRAPHIC_ABI_VERSION, GRAPHIC_CAP_INTERPOLATION | GRAPHIC_CAP_PREWARM, "raylib" };
+	return &descriptor;
+}
+
 extern "C" IGraphic* createGraphic() {
 	return new RaylibGraphic();
 }
@@ -0,0 +1,80 @@
+#pragma once
+#include "Input.hpp"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*
+Replay files hold the seed of every game plus the ticks at which the snake actually turned,
+which is all GameManager::update() needs to play the game again bit for bit.
+
+Layout (every number is an unsigned LEB128 varint unless noted):
+	"NBRP" magic, version byte, width, height, snakes, foods   (version 2 files stop at height: one of each)
+	per game:
+		seed
+		events: ((tickDelta + 1) << 2) | direction   tickDelta counts from the previous turn (or tick 0),
+		                                             direction is Up, Down, Left, Right as 0..3
+		0                                            end of the event list
+		ticks played, score, finished (1 if the game ended by itself, 0 if the session was quit mid-game)
+*/
+
+struct ReplayEvent {
+	long	tick;
+	Input	input;
+};
+
+struct ReplayGame {
+	uint64_t					seed;
+	std::vector<ReplayEvent>	events;
+	long						ticks;
+	int							score;
+	bool						finished;
+};
+
+class ReplayRecorder {
+	private:
+		std::ofstream			_file;
+		std::vector<uint8_t>	_buffer;
+		long					_lastTick;
+		bool					_inGame;
+
+		void writeVarint(uint64_t value);
+		void flush();
+
+	public:
+		ReplayRecorder(const char *path, int width, int height, int snakes = 1, int foods = 1);
+
+		ReplayRecorder(const ReplayRecorder &other) = delete;
+		ReplayRecorder &operator=(const ReplayRecorder &other) = delete;
+
+		~ReplayRecorder();
+
+		bool isOpen() const;
+		bool isInGame() const;
+
+		void beginGame(uint64_t seed);
+		// Called by GameManager for every input that changed the snake's direction, at the tick it took effect
+		void recordTurn(long tick, Input input);
+		void endGame(long ticks, int score, bool finished);
+};
+
+class ReplayPlayer {
+	private:
+		int						_width;
+		int						_height;
+		int						_snakes;
+		int						_foods;
+		std::vector<ReplayGame>	_games;
+
+	public:
+		ReplayPlayer();
+
+		bool load(const char *path);
+
+		int getWidth() const;
+		int getHeight() const;
+		int getSnakeCount() const;
+		int getFoodCount() const;
+		const std::vector<ReplayGame> &getGames() const;
+};
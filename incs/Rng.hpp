@@ -0,0 +1,55 @@
+#pragma once
+#include "DataStructs.hpp"
+#include <cstdint>
+
+/*
+Small, fast PRNG (xoshiro256**) owned by whoever needs randomness, e.g. one per game.
+The same seed always yields the same sequence, so a game is reproducible from its seed,
+and games running side by side never touch each other's state.
+*/
+class Rng {
+	private:
+		uint64_t	_state[4];
+
+		static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+	public:
+		struct State {
+			uint64_t	words[4];
+		};
+
+		Rng();
+		explicit Rng(uint64_t seed);
+
+		// Expands the 64-bit seed into the full state with splitmix64, as recommended for xoshiro
+		void seed(uint64_t seed);
+
+		State getState() const;
+		void setState(const State &state);
+
+		uint64_t next() {
+			const uint64_t result = rotl(_state[1] * 5, 7) * 9;
+			const uint64_t t = _state[1] << 17;
+
+			_state[2] ^= _state[0];
+			_state[3] ^= _state[1];
+			_state[1] ^= _state[2];
+			_state[0] ^= _state[3];
+			_state[2] ^= t;
+			_state[3] = rotl(_state[3], 45);
+
+			return result;
+		}
+
+		// Uniform in [0, max], both ends included
+		int getInt(int max);
+		// Uniform in [min, max], both ends included
+		int getRangeInt(int min, int max);
+		// Uniform cell in [0, xMax - 1] x [0, yMax - 1]
+		Vec2 getVec2(int xMax, int yMax);
+		// Uniform in [0, 1)
+		float getFloat();
+
+		// Fresh seed from std::random_device, for when no seed was given
+		static uint64_t randomSeed();
+};
@@ -43,15 +43,21 @@ class SDLGraphic : public IGraphic {
 		float											animationSpeed;
 		bool											enableTunnelEffect;
 
-		// This is needed for explosion particle spawning
-		int												lastFoodX;
-		int												lastFoodY;
+		// This is needed for explosion particle spawning, one entry per food
+		std::vector<Vec2>								lastFoods;
 		
 		// Snake trail tracking for interpolation -> the lerping of the trail particles, so that they don't look BAD
 		float											lastTailX;
 		float											lastTailY;
 		bool											isFirstFrame;
 
+		// Fraction of the current tick already elapsed; head and tail are drawn that far along their last move
+		float											interpolation;
+
+		// Font file read by prewarm(), possibly on another thread; the fonts are opened from it in init()
+		std::vector<char>								fontData;
+		bool											isPrewarmed;
+
 		// Colors
 		static constexpr SDL_Color customWhite{255, 248, 227, 255};	// Off-white
 		static constexpr SDL_Color customGray{136, 136, 136, 255};	// Gray
@@ -61,6 +67,7 @@ class SDLGraphic : public IGraphic {
 		//static constexpr SDL_Color darkRed{180, 52, 58, 255};
 
 		static constexpr SDL_Color lightBlue{70, 130, 180, 255};
+		static constexpr SDL_Color lightPurple{147, 112, 219, 255};	// Bot snakes
 		//static constexpr SDL_Color darkBlue{18, 45, 68, 255};
 		
 		// Helper function to set render color from SDL_Color
@@ -72,8 +79,8 @@ class SDLGraphic : public IGraphic {
 		float easeInQuad(float t);
 
 		// Drawing functions
-		void drawSnake(const GameState &state);
-		void drawFood(const GameState &state);
+		void drawSnake(const Snake &snake);
+		void drawFood(const Food &food, Vec2 &lastFood);
 		void drawBorder(int thickness);
 		void drawInstructions(int centerX, int centerY);
 		void drawRetryText(const GameState &state, int centerX, int centerY);	public:
@@ -83,12 +90,23 @@ class SDLGraphic : public IGraphic {
 		~SDLGraphic();
 		
 		void init(int width, int height) override;
+		void prewarm(int width, int height) override;
 		void render(const GameState& state, float deltaTime) override;
 		void renderMenu(const GameState &state, float deltaTime) override;
 		void renderGameOver(const GameState &state, float deltaTime) override;
 		Input pollInput() override;
+		void present() override;
+		int waitEvents(int timeoutMs) override;
+		void suspend() override;
+		void resume() override;
+		void setInterpolation(float alpha) override;
 };
 
+extern "C" const GraphicDescriptor *getGraphicDescriptor() {
+	static const GraphicDescriptor descriptor = { GRAPHIC_ABI_VERSION, GRAPHIC_CAP_INTERPOLATION | GRAPHIC_CAP_PREWARM, "sdl" };
+	return &descriptor;
+}
+
 extern "C" IGraphic* createGraphic() {
 	return new SDLGraphic();
 }
@@ -0,0 +1,64 @@
+#pragma once
+#include "DataStructs.hpp"
+#include <span>
+#include <vector>
+
+/*
+Double-ended store for the snake body as packed cells, head first. Segments live in fixed-size chunks
+reached through a circular map of chunk pointers, so pushing at either end never moves what is stored: the map
+only doubles (copying pointers) when it runs out of slots. Chunks emptied by pop_back() or clear() go to
+a spare list and are handed out again before anything new is allocated, so a snake that keeps moving,
+or a game that restarts, settles into a fixed set of chunks sized by the longest body seen so far.
+*/
+class SegmentStore {
+	public:
+		static const int	CHUNK_SHIFT = 9;
+		static const int	CHUNK_SIZE = 1 << CHUNK_SHIFT;	// 512 segments, 2 KiB per chunk
+
+	private:
+		static const int	CHUNK_MASK = CHUNK_SIZE - 1;
+
+		std::vector<Cell*>	_map;			// circular, power-of-two size; only _chunkCount slots from _firstChunk are live
+		std::vector<Cell*>	_spare;
+		size_t				_firstChunk;
+		size_t				_chunkCount;
+		int					_front;			// offset of element 0 inside the first chunk
+		int					_length;
+
+		Cell *&chunk(size_t index) { return _map[(_firstChunk + index) & (_map.size() - 1)]; }
+		Cell *chunk(size_t index) const { return _map[(_firstChunk + index) & (_map.size() - 1)]; }
+		Cell *takeChunk();
+		Cell *appendChunk();
+		void growMap();
+
+	public:
+		SegmentStore();
+
+		SegmentStore(const SegmentStore &other);
+		SegmentStore &operator=(const SegmentStore &other);
+
+		~SegmentStore();
+
+		int size() const { return _length; }
+		bool empty() const { return _length == 0; }
+
+		Cell operator[](int index) const {
+			int pos = _front + index;
+			return chunk(pos >> CHUNK_SHIFT)[pos & CHUNK_MASK];
+		}
+
+		// The longest contiguous stretch starting at index; walk a range with
+		// `for (i = 0; i < size(); i += run.size())` to visit it in a handful of spans
+		std::span<const Cell> run(int index) const;
+
+		void push_front(Cell segment);
+		void push_back(Cell segment);
+		void pop_back();
+		// Drops every segment but keeps the chunks for the next body
+		void clear();
+		void assign(std::span<const Cell> segments);
+		void assign(std::span<const Vec2> segments);
+
+		// Chunks currently allocated, in use or spare
+		size_t getChunkCapacity() const { return _chunkCount + _spare.size(); }
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include "DataStructs.hpp"
+#include "Input.hpp"
+#include "GameManager.hpp"
+#include "GameSnapshot.hpp"
+#include "TripleBuffer.hpp"
+#include "TickScheduler.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/*
+Runs GameManager::update() at a fixed rate on its own thread, so ticks keep their pace however long
+a frame takes to render. After every tick the whole game is captured into a GameSnapshot and
+published through a triple buffer; the render side restores the latest one into its own copy of the
+game and never touches the live state. Inputs go straight into the GameManager's lock-free queue,
+stamped when they were read, and each tick takes the ones that arrived before its deadline. A wakeup
+later than the catch-up budget drops the missed ticks rather than running them back to back. The
+thread only ticks while a game is being played: stop() parks it and waits until it is idle, after
+which the live state belongs to the caller again (pause, game over, restart). One worker is spawned
+on the first start() and reused for the whole session.
+*/
+class SimulationThread {
+	private:
+		// A snapshot and the tick time it was taken for, so the renderer knows how far the next one is
+		struct PublishedTick {
+			GameSnapshot							snapshot;
+			std::chrono::steady_clock::time_point	time;
+		};
+
+		enum class Command {
+			Park,
+			Run,
+			Exit
+		};
+
+		GameManager					&_manager;
+		GameState					&_state;
+		std::chrono::nanoseconds	_tickLength;
+		std::chrono::nanoseconds	_maxCatchUp;
+
+		TripleBuffer<PublishedTick>	_snapshots;
+		std::thread					_thread;
+		std::atomic<bool>			_finished;
+		bool						_started;		// caller side only
+
+		// Hands the game back and forth; the worker never holds it while ticking
+		std::mutex					_controlMutex;
+		std::condition_variable		_control;
+		Command						_command;
+		bool						_active;
+		TickCounters				_counters;
+
+		void run();
+
+	public:
+		SimulationThread(GameManager &manager, GameState &state, double tickSeconds, double maxCatchUpSeconds);
+
+		SimulationThread(const SimulationThread &other) = delete;
+		SimulationThread &operator=(const SimulationThread &other) = delete;
+
+		~SimulationThread();
+
+		void start();
+		void stop();
+		bool isRunning() const;
+		// Set once a tick ended the game; the thread stops ticking by itself
+		bool hasFinished() const;
+		TickCounters getTickCounters();
+
+		// Render side: picks up the newest published snapshot, returns whether it changed
+		bool acquireLatest();
+		const GameSnapshot &latest() const;
+		// How far (0 to 1) now is from latest() towards the tick after it
+		float getInterpolation(std::chrono::steady_clock::time_point now) const;
+};
@@ -1,6 +1,11 @@
 #pragma once
 #include "DataStructs.hpp"
+#include "OccupancyGrid.hpp"
+#include "Rng.hpp"
+#include "SegmentStore.hpp"
 #include "Utils.hpp"
+#include <iterator>
+#include <span>
 
 enum class Direction {
 	Left,
@@ -11,25 +16,102 @@ enum class Direction {
 
 class Snake {
 	private:
-		int			_length;
-		int			_maxLength;
-		Vec2		*_segments;
-		Direction	_direction;
+		// Head first; storage grows with the body, _maxLength is only the arena-imposed cap
+		SegmentStore	_segments;
+		int				_maxLength;
+		int				_pendingGrowth;
+		Direction		_direction;
+		OccupancyGrid	*_occupancy;
+		int				_id;			// owner id on the occupancy grid; 0 is the player
+		bool			_alive;
+		bool			_headOnBody;
+		// Where the head and tail were before the last move, for drawing in between ticks
+		Vec2			_previousHead;
+		Vec2			_previousTail;
 
+		static const int	SPAWN_ATTEMPTS = 16;
+
+		void layOut(Rng &rng);
+		void spawn(Rng &rng);
+		void bodyReplaced(Direction dir, int pendingGrowth);
 
 	public:
+		class const_iterator {
+			private:
+				const Snake	*_snake;
+				int			_index;
+
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = Vec2;
+				using difference_type = std::ptrdiff_t;
+				using pointer = void;
+				using reference = Vec2;
+
+				const_iterator() : _snake(nullptr), _index(0) {}
+				const_iterator(const Snake *snake, int index) : _snake(snake), _index(index) {}
+
+				reference operator*() const { return _snake->getSegment(_index); }
+
+				const_iterator &operator++() { ++_index; return *this; }
+				const_iterator operator++(int) { const_iterator tmp = *this; ++_index; return tmp; }
+
+				bool operator==(const const_iterator &other) const { return _index == other._index; }
+				bool operator!=(const const_iterator &other) const { return _index != other._index; }
+		};
+
 		Snake() = delete;
-		Snake(int width, int height);
+		Snake(int width, int height, OccupancyGrid &occupancy, Rng &rng, int id = 0);
 
-		Snake(const Snake &other);
-		Snake &operator=(const Snake &other);
-		
-		~Snake();
+		Snake(const Snake &other) = default;
+		Snake &operator=(const Snake &other) = default;
 
+		~Snake() = default;
+
+		// Starts a fresh game on the same arena, drawing from rng exactly like the constructor,
+		// but keeps the storage the previous body grew.
+		// The player (id 0) starts the game, so it wipes the whole grid first; any other snake joins an arena
+		// already in play and only comes back alive if it finds room for its whole body
+		void respawn(Rng &rng);
+		// Takes the body off the grid and out of the game until the next respawn()
+		void kill();
+
+		int getId() const;
+		bool isAlive() const;
 		int getLength() const;
-		const Vec2 *getSegments() const;
+
+		// Head-to-tail access (index 0 is the head, getLength() - 1 the tail), unpacked for callers outside the core
+		Vec2 getSegment(int index) const;
+		Vec2 getHead() const;
+		Vec2 getTail() const;
+		// Where the head goes on the next move
+		Vec2 getNextHead() const;
+		Cell getHeadCell() const;
+		Cell getTailCell() const;
+		// Longest contiguous stretch of the body starting at index, for bulk copies
+		std::span<const Cell> getSegmentRun(int index) const;
+
+		const_iterator begin() const;
+		const_iterator end() const;
+
+		// Set by move() when the new head landed on a cell the body already held
+		bool isHeadOnBody() const;
+		Direction getDirection() const;
+		int getPendingGrowth() const;
+		const Vec2 &getPreviousHead() const;
+		const Vec2 &getPreviousTail() const;
+
+		// Replace the whole body (head first) and restamp the occupancy grid accordingly
+		void setBody(std::span<const Vec2> body, Direction dir, int pendingGrowth = 0);
+		void setBody(std::span<const Cell> body, Direction dir, int pendingGrowth = 0);
+		// setBody() leaves the snake standing still; these put the last move back
+		void setPreviousEnds(Vec2 head, Vec2 tail);
+		void setHeadOnBody(bool headOnBody);
 
 		void move();
+		// move() in two halves, so every snake in an arena can let go of its tail before any head moves on
+		void moveTail();
+		void moveHead();
 		void changeDirection(Direction dir);
 		void grow();
-};
\ No newline at end of file
+};
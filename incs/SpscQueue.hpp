@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+/*
+Fixed-capacity lock-free ring for exactly one producer thread and one consumer thread. push() is
+the producer's only call; everything else belongs to the consumer. Head and tail sit on their own
+cache lines so the two sides don't keep stealing each other's line. Capacity must be a power of two.
+*/
+template <typename T, size_t Capacity>
+class SpscQueue {
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+	private:
+		static constexpr size_t	MASK = Capacity - 1;
+
+		alignas(64) std::atomic<size_t>	_head;	// next slot to read, written by the consumer
+		alignas(64) std::atomic<size_t>	_tail;	// next slot to write, written by the producer
+		T								_slots[Capacity];
+
+	public:
+		SpscQueue() : _head(0), _tail(0) {}
+
+		SpscQueue(const SpscQueue &other) = delete;
+		SpscQueue &operator=(const SpscQueue &other) = delete;
+
+		// Producer side: false (and nothing queued) when the ring is full
+		bool push(const T &value) {
+			size_t tail = _tail.load(std::memory_order_relaxed);
+			if (tail - _head.load(std::memory_order_acquire) == Capacity)
+				return false;
+			_slots[tail & MASK] = value;
+			_tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Consumer side
+		size_t size() const {
+			return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_relaxed);
+		}
+
+		bool empty() const { return size() == 0; }
+
+		// index-th oldest entry; only valid below size()
+		const T &peek(size_t index = 0) const {
+			return _slots[(_head.load(std::memory_order_relaxed) + index) & MASK];
+		}
+
+		// Drops the oldest entry; the queue must not be empty
+		void pop() {
+			_head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+
+		bool pop(T &value) {
+			size_t head = _head.load(std::memory_order_relaxed);
+			if (head == _tail.load(std::memory_order_acquire))
+				return false;
+			value = _slots[head & MASK];
+			_head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		void clear() {
+			_head.store(_tail.load(std::memory_order_acquire), std::memory_order_release);
+		}
+};
@@ -4,6 +4,8 @@
 #include <SDL2/SDL.h>
 #include <SDL_ttf.h>
 #include <string>
+#include <vector>
+#include <fstream>
 #include <iostream>
 #include "colors.h"
 
@@ -23,7 +25,12 @@ public:
 	TextRenderer(SDL_Renderer* renderer);
 	~TextRenderer();
 
-	bool init(int windowWidth);
+	// Reads the font file into memory; needs no SDL, so it can run ahead of init() on another thread
+	static std::vector<char> readFontFile();
+
+	// Opens the fonts from fontData when it holds a file read by readFontFile(), from disk otherwise.
+	// fontData has to outlive the renderer
+	bool init(int windowWidth, const std::vector<char> &fontData);
 
 	bool renderText(const std::string& text, int x, int y, int offset, 
 	                TTF_Font* fontToUse, SDL_Color color, bool centered = false);
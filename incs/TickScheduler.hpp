@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+
+struct TickCounters {
+	uint64_t	run;			// ticks simulated
+	uint64_t	dropped;		// ticks skipped because a stall went over the catch-up budget
+	uint64_t	dilatedFrames;	// frames (or wakeups) that had to drop ticks
+};
+
+/*
+Fixed-step accumulator for the frame loop. After a stall (a library switch re-running init(), a
+debugger break...) it runs at most the catch-up budget worth of ticks in one go and lets the rest
+of the lost time go: the game briefly slows down instead of fast-forwarding the snake into a wall
+before anything is drawn. Turbo mode ignores time altogether and runs a fixed number of ticks per
+frame, for soak tests.
+*/
+class TickScheduler {
+	private:
+		double			_tickLength;
+		int				_maxCatchUp;	// ticks per frame
+		int				_turbo;			// ticks per frame, 0 when off
+		double			_accumulator;
+		int				_due;
+		TickCounters	_counters;
+
+	public:
+		TickScheduler(double tickSeconds, double maxCatchUpSeconds);
+
+		void setTurbo(int ticksPerFrame);
+		bool isTurbo() const;
+
+		// Forget pending time, e.g. when a game starts or resumes
+		void reset();
+		// Adds a frame's worth of time; ticks due are then taken one by one
+		void advance(double elapsedSeconds);
+		bool takeTick();
+
+		// Fraction of the next tick already elapsed (1 in turbo mode, where time doesn't matter)
+		double getAlpha() const;
+		double getTimeToNextTick() const;
+		const TickCounters &getCounters() const;
+};
@@ -0,0 +1,83 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+Opt-in timeline tracer. Once enabled, TRACE_SCOPE("name") records how long the enclosing scope took
+into a ring buffer owned by the calling thread (no locks, no allocation after the thread's first
+event; the oldest events are overwritten when it fills up). write() dumps every thread's events as
+Chrome trace-event JSON, which chrome://tracing and ui.perfetto.dev open as is.
+While disabled a scope costs one relaxed atomic load.
+Event names are stored by pointer, so they must be string literals.
+*/
+
+struct TraceEvent {
+	const char	*name;
+	uint64_t	start;		// ns since Tracer::enable()
+	uint64_t	duration;	// ns
+};
+
+class Tracer {
+	public:
+		static const size_t	DEFAULT_CAPACITY = 1 << 16;
+
+	private:
+		struct ThreadBuffer {
+			std::vector<TraceEvent>	events;
+			std::atomic<uint64_t>	written;
+			int						tid;
+			std::string				name;
+		};
+
+		static std::atomic<bool>							_enabled;
+		static size_t										_capacity;
+		static std::mutex									_registryMutex;
+		static std::vector<std::unique_ptr<ThreadBuffer>>	_buffers;
+
+		static ThreadBuffer *local();
+
+	public:
+		static void enable(size_t eventsPerThread = DEFAULT_CAPACITY);
+		static bool isEnabled() { return _enabled.load(std::memory_order_relaxed); }
+
+		static uint64_t now();
+		// Trace time of a steady_clock reading taken elsewhere, e.g. by FrameStats
+		static uint64_t fromClock(std::chrono::steady_clock::time_point time);
+		static void record(const char *name, uint64_t start, uint64_t end);
+		// Label for the calling thread in the trace viewer
+		static void setThreadName(const std::string &name);
+
+		// Call once the traced threads are done (or idle); events still being written may be skipped
+		static bool write(const std::string &path);
+};
+
+class TraceScope {
+	private:
+		const char	*_name;
+		uint64_t	_start;
+		bool		_active;
+
+	public:
+		explicit TraceScope(const char *name) : _name(name), _start(0), _active(Tracer::isEnabled()) {
+			if (_active)
+				_start = Tracer::now();
+		}
+
+		TraceScope(const TraceScope &other) = delete;
+		TraceScope &operator=(const TraceScope &other) = delete;
+
+		~TraceScope() {
+			if (_active)
+				Tracer::record(_name, _start, Tracer::now());
+		}
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+/*
+Lock-free single-writer / single-reader triple buffer. The writer fills back() and publish()es it;
+the reader calls update() and then reads front(), which is always the most recently published
+value. Neither side ever waits: the writer just keeps overwriting its own buffer, and the reader
+skips any values published in between two of its updates.
+*/
+template <typename T>
+class TripleBuffer {
+	private:
+		static constexpr uint8_t	INDEX_MASK = 0x3;
+		static constexpr uint8_t	FRESH = 0x4;	// set on the shared index when it holds an unread value
+
+		T						_buffers[3];
+		std::atomic<uint8_t>	_shared;
+		uint8_t					_back;
+		uint8_t					_front;
+
+	public:
+		TripleBuffer() : _shared(1), _back(0), _front(2) {}
+
+		TripleBuffer(const TripleBuffer &other) = delete;
+		TripleBuffer &operator=(const TripleBuffer &other) = delete;
+
+		// Writer side
+		T &back() { return _buffers[_back]; }
+
+		void publish() {
+			uint8_t previous = _shared.exchange(_back | FRESH, std::memory_order_acq_rel);
+			_back = previous & INDEX_MASK;
+		}
+
+		// Reader side: returns whether front() changed
+		bool update() {
+			if (!(_shared.load(std::memory_order_relaxed) & FRESH))
+				return false;
+			uint8_t previous = _shared.exchange(_front, std::memory_order_acq_rel);
+			_front = previous & INDEX_MASK;
+			return true;
+		}
+
+		const T &front() const { return _buffers[_front]; }
+};
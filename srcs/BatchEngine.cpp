@@ -0,0 +1,145 @@
+#include "../incs/BatchEngine.hpp"
+#include "../incs/Tracer.hpp"
+#include <algorithm>
+#include <iostream>
+
+BatchEngine::BatchEngine(int width, int height, int count, int threads, uint64_t seed) :
+	_width(width), _height(height), _count(count), _seed(seed),
+	_generation(0), _pending(0), _stopping(false) {
+	// Snakes and states keep references into the other vectors, so nothing may reallocate after this
+	_rngs.reserve(count);
+	_occupancy.reserve(count);
+	_snakes.reserve(count);
+	_foods.reserve(count);
+	_states.reserve(count);
+	_managers.reserve(count);
+
+	for (int i = 0; i < count; ++i) {
+		_rngs.emplace_back(seed + i);
+		_occupancy.emplace_back(width, height);
+		_snakes.emplace_back(width, height, _occupancy[i], _rngs[i]);
+		_foods.emplace_back(_rngs[i].getVec2(width - 1, height - 1), width, height, _rngs[i]);
+		_states.push_back(GameState{
+			width, height, _snakes[i], _foods[i], _occupancy[i], _rngs[i],
+			false,
+			true,
+			false,
+			GameStateType::Playing,
+			0,
+			std::span<Snake>(&_snakes[i], 1),
+			std::span<Food>(&_foods[i], 1)
+		});
+		_managers.push_back(std::make_unique<GameManager>(&_states[i]));
+	}
+	_alive.assign(count, 1);
+	_ticks.assign(count, 0);
+	_games.assign(count, 1);
+
+	// The calling thread takes range 0 itself, so only threads - 1 workers are spawned
+	int workerCount = std::max(1, std::min(threads, count));
+	for (int w = 1; w < workerCount; ++w)
+		_workers.emplace_back(&BatchEngine::workerLoop, this, w, workerCount);
+}
+
+BatchEngine::~BatchEngine() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_wake.notify_all();
+	for (auto &worker : _workers)
+		worker.join();
+}
+
+void BatchEngine::rangeFor(int worker, int workerCount, int &begin, int &end) const {
+	begin = static_cast<int>(static_cast<long>(_count) * worker / workerCount);
+	end = static_cast<int>(static_cast<long>(_count) * (worker + 1) / workerCount);
+}
+
+void BatchEngine::stepRange(int begin, int end) {
+	TRACE_SCOPE("batch_step");
+	for (int i = begin; i < end; ++i) {
+		if (!_alive[i])
+			continue;
+
+		_managers[i]->bufferInput(_actions[i]);
+		_managers[i]->update();
+		_ticks[i]++;
+
+		if (!_states[i].isRunning)
+			_alive[i] = 0;
+	}
+}
+
+void BatchEngine::workerLoop(int worker, int workerCount) {
+	int begin, end;
+	rangeFor(worker, workerCount, begin, end);
+	Tracer::setThreadName("batch worker " + std::to_string(worker));
+
+	long seenGeneration = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wake.wait(lock, [&]() { return _stopping || _generation != seenGeneration; });
+			if (_stopping)
+				return;
+			seenGeneration = _generation;
+		}
+
+		stepRange(begin, end);
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (--_pending == 0)
+				_done.notify_one();
+		}
+	}
+}
+
+bool BatchEngine::stepAll(std::span<const Input> actions) {
+	if (static_cast<int>(actions.size()) < _count) {
+		std::cerr << "BatchEngine: " << actions.size() << " actions for " << _count << " arenas" << std::endl;
+		return false;
+	}
+
+	int workerCount = static_cast<int>(_workers.size()) + 1;
+	_actions = actions;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_pending = workerCount - 1;
+		_generation++;
+	}
+	_wake.notify_all();
+
+	int begin, end;
+	rangeFor(0, workerCount, begin, end);
+	stepRange(begin, end);
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_done.wait(lock, [&]() { return _pending == 0; });
+	return true;
+}
+
+// Same restart as single-game play: reseed, rewind the tick, then respawn
+void BatchEngine::resetArena(int arena) {
+	_rngs[arena].seed(_seed + arena + static_cast<uint64_t>(_games[arena]++) * _count);
+	_managers[arena]->resetTick();
+	_snakes[arena].respawn(_rngs[arena]);
+	_foods[arena] = Food(_rngs[arena].getVec2(_width - 1, _height - 1), _width, _height, _rngs[arena]);
+	_states[arena].score = 0;
+	_states[arena].isRunning = true;
+	_managers[arena]->clearInputBuffer();
+	_alive[arena] = 1;
+	_ticks[arena] = 0;
+}
+
+int BatchEngine::getCount() const { return _count; }
+
+bool BatchEngine::isAlive(int arena) const { return _alive[arena]; }
+
+int BatchEngine::getScore(int arena) const { return _states[arena].score; }
+
+long BatchEngine::getTicks(int arena) const { return _ticks[arena]; }
+
+const GameState &BatchEngine::getState(int arena) const { return _states[arena]; }
@@ -0,0 +1,45 @@
+#include "../incs/Bot.hpp"
+#include "../incs/Snake.hpp"
+#include "../incs/OccupancyGrid.hpp"
+#include "../incs/Rng.hpp"
+#include <cstdlib>
+
+static Vec2 step(Vec2 cell, Input dir) {
+	switch (dir) {
+		case Input::Up:		cell.y--; break;
+		case Input::Down:	cell.y++; break;
+		case Input::Left:	cell.x--; break;
+		case Input::Right:	cell.x++; break;
+		default:			break;
+	}
+	return cell;
+}
+
+static int distance(Vec2 a, Vec2 b) {
+	return std::abs(a.x - b.x) + std::abs(a.y - b.y);
+}
+
+Input Bot::steer(const Snake &snake, Vec2 target, const OccupancyGrid &occupancy, Rng &rng) {
+	static const Input directions[] = { Input::Up, Input::Down, Input::Left, Input::Right };
+
+	Vec2 head = snake.getHead();
+
+	Input safe[4];
+	Input closer[4];
+	int safeCount = 0;
+	int closerCount = 0;
+	for (Input dir : directions) {
+		Vec2 next = step(head, dir);
+		if (!occupancy.isFree(next))
+			continue;
+		safe[safeCount++] = dir;
+		if (distance(next, target) < distance(head, target))
+			closer[closerCount++] = dir;
+	}
+
+	if (safeCount == 0)
+		return Input::None;
+	if (closerCount > 0 && rng.getInt(3) != 0)
+		return closer[rng.getInt(closerCount - 1)];
+	return safe[rng.getInt(safeCount - 1)];
+}
@@ -0,0 +1,149 @@
+#include "../incs/CellKernels.hpp"
+#include <atomic>
+
+#if defined(__x86_64__)
+# include <immintrin.h>
+# define NIBBLER_X86_SIMD 1
+#endif
+
+// -=-=-=-=-    SCALAR -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- //
+
+static size_t findScalar(const Cell *cells, size_t count, Cell target) {
+	for (size_t i = 0; i < count; ++i) {
+		if (cells[i] == target)
+			return i;
+	}
+	return count;
+}
+
+static void packScalar(const Vec2 *in, size_t count, Cell *out) {
+	for (size_t i = 0; i < count; ++i)
+		out[i] = packCell(in[i]);
+}
+
+#ifdef NIBBLER_X86_SIMD
+
+// -=-=-=-=-    SSE2 -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- //
+// x86-64 always has SSE2, so these need no target attribute.
+// Vec2 runs are x0 y0 x1 y1 ... as int32; a saturating pack to int16 leaves exactly the Cell layout
+// because every coordinate already fits.
+
+static size_t findSse2(const Cell *cells, size_t count, Cell target) {
+	__m128i needle = _mm_set1_epi32(static_cast<int>(target));
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m128i a = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(cells + i)), needle);
+		__m128i b = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(cells + i + 4)), needle);
+		int mask = _mm_movemask_ps(_mm_castsi128_ps(a)) | (_mm_movemask_ps(_mm_castsi128_ps(b)) << 4);
+		if (mask)
+			return i + __builtin_ctz(mask);
+	}
+	return i + findScalar(cells + i, count - i, target);
+}
+
+static void packSse2(const Vec2 *in, size_t count, Cell *out) {
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+		__m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 2));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(low, high));
+	}
+	packScalar(in + i, count - i, out + i);
+}
+
+// -=-=-=-=-    AVX2 -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- //
+// Tails go to the scalar loops, never the SSE2 ones: legacy SSE code running with the upper
+// halves of the ymm registers still dirty pays a state-transition penalty on many Intel cores.
+
+__attribute__((target("avx2")))
+static size_t findAvx2(const Cell *cells, size_t count, Cell target) {
+	__m256i needle = _mm256_set1_epi32(static_cast<int>(target));
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		__m256i a = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(cells + i)), needle);
+		__m256i b = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(cells + i + 8)), needle);
+		int mask = _mm256_movemask_ps(_mm256_castsi256_ps(a)) | (_mm256_movemask_ps(_mm256_castsi256_ps(b)) << 8);
+		if (mask)
+			return i + __builtin_ctz(mask);
+	}
+	return i + findScalar(cells + i, count - i, target);
+}
+
+// The 256-bit pack works per 128-bit lane, so the result comes out as cells 0 1 4 5 2 3 6 7
+// and one cross-lane permute puts it back in order
+__attribute__((target("avx2")))
+static void packAvx2(const Vec2 *in, size_t count, Cell *out) {
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+		__m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 4));
+		__m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(low, high), 0xD8);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+	}
+	packScalar(in + i, count - i, out + i);
+}
+
+#endif
+
+// -=-=-=-=-    DISPATCH -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- //
+
+static SimdLevel detectLevel() {
+#ifdef NIBBLER_X86_SIMD
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return SimdLevel::Avx2;
+	return SimdLevel::Sse2;
+#else
+	return SimdLevel::Scalar;
+#endif
+}
+
+static std::atomic<SimdLevel> &activeLevel() {
+	static std::atomic<SimdLevel> level(CellKernels::getSupportedLevel());
+	return level;
+}
+
+SimdLevel CellKernels::getSupportedLevel() {
+	static const SimdLevel supported = detectLevel();
+	return supported;
+}
+
+SimdLevel CellKernels::getLevel() {
+	return activeLevel().load(std::memory_order_relaxed);
+}
+
+void CellKernels::setLevel(SimdLevel level) {
+	if (level > getSupportedLevel())
+		level = getSupportedLevel();
+	activeLevel().store(level, std::memory_order_relaxed);
+}
+
+const char *CellKernels::getLevelName(SimdLevel level) {
+	switch (level) {
+		case SimdLevel::Avx2:	return "avx2";
+		case SimdLevel::Sse2:	return "sse2";
+		default:				return "scalar";
+	}
+}
+
+size_t CellKernels::find(const Cell *cells, size_t count, Cell target) {
+#ifdef NIBBLER_X86_SIMD
+	switch (getLevel()) {
+		case SimdLevel::Avx2:	return findAvx2(cells, count, target);
+		case SimdLevel::Sse2:	return findSse2(cells, count, target);
+		default:				break;
+	}
+#endif
+	return findScalar(cells, count, target);
+}
+
+void CellKernels::pack(const Vec2 *in, size_t count, Cell *out) {
+#ifdef NIBBLER_X86_SIMD
+	switch (getLevel()) {
+		case SimdLevel::Avx2:	packAvx2(in, count, out); return;
+		case SimdLevel::Sse2:	packSse2(in, count, out); return;
+		default:				break;
+	}
+#endif
+	packScalar(in, count, out);
+}
@@ -1,9 +1,11 @@
 #include "../incs/Food.hpp"
 #include "../incs/Snake.hpp"
+#include "../incs/OccupancyGrid.hpp"
+#include "../incs/Tracer.hpp"
 #include <iostream>
 
-Food::Food(Vec2 position, int width, int height) : _position(position), _hLimit(width), _vLimit(height) {
-	_foodChar = Utils::getFoodChar(Utils::getRandomInt(5));
+Food::Food(Vec2 position, int width, int height, Rng &rng) : _position(packCell(position)), _hLimit(width), _vLimit(height) {
+	_foodChar = Utils::getFoodChar(rng.getInt(5));
 }
 
 Food::Food(const Food &other)
@@ -16,6 +18,9 @@ Food &Food::operator=(const Food & other)
 	if (this != &other)
 	{
 		this->_position = other._position;
+		this->_hLimit = other._hLimit;
+		this->_vLimit = other._vLimit;
+		this->_foodChar = other._foodChar;
 	}
 
 	return *this;
@@ -23,47 +28,30 @@ Food &Food::operator=(const Food & other)
 
 bool Food::replaceInFreeSpace(GameState *gameState)
 {
-	std::vector<Vec2> snakeSegments;
-	for (int i = 0; i < gameState->snake.getLength(); i++) {
-		snakeSegments.push_back(gameState->snake.getSegments()[i]);
-	}
-
-	std::vector<Vec2> availableCells;
-	availableCells.reserve(_hLimit * _vLimit - snakeSegments.size());
-
-	for (int y = 0; y < _vLimit; y++) {
-		for (int x = 0; x < _hLimit; x++)
-		{
-			Vec2 candidate = {x, y};
+	TRACE_SCOPE("food_replace");
+	const OccupancyGrid &occupancy = gameState->occupancy;
+	int freeCount = occupancy.getFreeCount();
 
-			bool occupied = false;
-			for (const auto &segment : snakeSegments) {
-				if (segment.x == candidate.x && segment.y == candidate.y)
-				{
-					occupied = true;
-					break;
-				}
-			}
-
-			if (!occupied) {
-				availableCells.push_back(candidate);
-			}
-		}
-	}
-
-	if (availableCells.empty())
+	if (freeCount == 0)
 	{
 		std::cout << "No available cells! aka you Won, bb" << std::endl;
 		return false;
 	}
 
-	int randomIndex = Utils::getRandomInt(availableCells.size() - 1);
-	_position = availableCells[randomIndex];
-	_foodChar = Utils::getFoodChar(Utils::getRandomInt(5));
+	Rng &rng = gameState->rng;
+	_position = packCell(occupancy.getFreeCell(rng.getInt(freeCount - 1)));
+	_foodChar = Utils::getFoodChar(rng.getInt(5));
 
 	return true;
 }
 
-Vec2 Food::getPosition() const { return _position; }
+void Food::place(Vec2 position, const char *foodChar) {
+	_position = packCell(position);
+	_foodChar = foodChar;
+}
+
+Vec2 Food::getPosition() const { return unpackCell(_position); }
+
+Cell Food::getCell() const { return _position; }
 
 const char *Food::getFoodChar() const { return _foodChar; };
@@ -0,0 +1,60 @@
+#include "../incs/FrameScheduler.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <poll.h>
+#include <sys/timerfd.h>
+#include <thread>
+#include <unistd.h>
+
+FrameScheduler::FrameScheduler() : _timerFd(timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK)) {}
+
+FrameScheduler::~FrameScheduler() {
+	if (_timerFd >= 0)
+		close(_timerFd);
+}
+
+// steady_clock counts CLOCK_MONOTONIC, so its time points can be armed on the timer as they are
+bool FrameScheduler::waitOnFd(int inputFd, std::chrono::steady_clock::time_point deadline) {
+	std::chrono::nanoseconds sinceEpoch = deadline.time_since_epoch();
+	itimerspec spec {};
+	spec.it_value.tv_sec = std::chrono::duration_cast<std::chrono::seconds>(sinceEpoch).count();
+	spec.it_value.tv_nsec = (sinceEpoch % std::chrono::seconds(1)).count();
+	if (timerfd_settime(_timerFd, TFD_TIMER_ABSTIME, &spec, nullptr) == -1) {
+		std::this_thread::sleep_until(deadline);
+		return false;
+	}
+
+	pollfd fds[2] = {
+		{ _timerFd, POLLIN, 0 },
+		{ inputFd, POLLIN, 0 }
+	};
+	int ready = poll(fds, inputFd >= 0 ? 2 : 1, -1);
+
+	if (fds[0].revents & POLLIN) {
+		uint64_t expirations;
+		ssize_t drained = read(_timerFd, &expirations, sizeof(expirations));
+		(void)drained;
+	}
+	return ready > 0 && inputFd >= 0 && (fds[1].revents & POLLIN);
+}
+
+bool FrameScheduler::waitUntil(std::chrono::steady_clock::time_point deadline, IGraphic &graphic) {
+	auto remaining = deadline - std::chrono::steady_clock::now();
+	if (remaining <= std::chrono::steady_clock::duration::zero())
+		return false;
+
+	int inputFd = graphic.getInputFd();
+	if (inputFd < 0) {
+		// Rounded up: waking a little late costs less than a second wait for the last fraction of a millisecond
+		int timeoutMs = static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(remaining).count());
+		int result = graphic.waitEvents(timeoutMs);
+		if (result >= 0)
+			return result > 0;
+	}
+
+	if (_timerFd < 0) {
+		std::this_thread::sleep_until(deadline);
+		return false;
+	}
+	return waitOnFd(inputFd, deadline);
+}
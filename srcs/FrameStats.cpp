@@ -0,0 +1,106 @@
+#include "../incs/FrameStats.hpp"
+#include "../incs/Tracer.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+FrameStats::FrameStats() : _ticks{ 0, 0, 0 }, _frameStart(clock::now()), _lapStart(_frameStart) {}
+
+const char *FrameStats::phaseName(FramePhase phase) {
+	switch (phase) {
+		case FramePhase::Poll:		return "poll";
+		case FramePhase::Update:	return "update";
+		case FramePhase::Render:	return "render";
+		case FramePhase::Present:	return "present";
+		case FramePhase::Sleep:		return "sleep";
+		case FramePhase::Switch:	return "switch";
+		case FramePhase::Frame:		return "frame";
+		default:					return "unknown";
+	}
+}
+
+void FrameStats::beginFrame() {
+	_frameStart = clock::now();
+	_lapStart = _frameStart;
+}
+
+void FrameStats::lap(FramePhase phase) {
+	clock::time_point now = clock::now();
+	_phases[static_cast<int>(phase)].record(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(now - _lapStart).count());
+	if (Tracer::isEnabled())
+		Tracer::record(phaseName(phase), Tracer::fromClock(_lapStart), Tracer::fromClock(now));
+	_lapStart = now;
+}
+
+void FrameStats::skipLap() {
+	_lapStart = clock::now();
+}
+
+// Reuses the last lap's timestamp, so closing the frame costs no extra clock read
+void FrameStats::endFrame() {
+	_phases[static_cast<int>(FramePhase::Frame)].record(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(_lapStart - _frameStart).count());
+	if (Tracer::isEnabled())
+		Tracer::record(phaseName(FramePhase::Frame), Tracer::fromClock(_frameStart), Tracer::fromClock(_lapStart));
+}
+
+const LatencyHistogram &FrameStats::get(FramePhase phase) const {
+	return _phases[static_cast<int>(phase)];
+}
+
+void FrameStats::setTickCounters(const TickCounters &counters) {
+	_ticks = counters;
+}
+
+bool FrameStats::write(const std::string &path) const {
+	bool csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+	return csv ? writeCsv(path) : writeJson(path);
+}
+
+bool FrameStats::writeJson(const std::string &path) const {
+	std::ofstream out(path);
+	if (!out.is_open()) {
+		std::cerr << "Failed to open frame stats output: " << path << std::endl;
+		return false;
+	}
+
+	out << "{\n  \"unit\": \"ns\",\n  \"phases\": [\n";
+	for (int i = 0; i < static_cast<int>(FramePhase::Count); ++i) {
+		const LatencyHistogram &h = _phases[i];
+		char line[256];
+		std::snprintf(line, sizeof(line),
+			"    {\"phase\": \"%s\", \"count\": %llu, \"mean\": %.1f, \"p50\": %llu, \"p99\": %llu, \"max\": %llu}%s\n",
+			phaseName(static_cast<FramePhase>(i)), static_cast<unsigned long long>(h.getCount()), h.getMean(),
+			static_cast<unsigned long long>(h.getPercentile(0.50)), static_cast<unsigned long long>(h.getPercentile(0.99)),
+			static_cast<unsigned long long>(h.getMax()), (i + 1 < static_cast<int>(FramePhase::Count)) ? "," : "");
+		out << line;
+	}
+	out << "  ],\n  \"ticks\": {\"run\": " << _ticks.run << ", \"dropped\": " << _ticks.dropped
+		<< ", \"dilated_frames\": " << _ticks.dilatedFrames << "}\n}\n";
+	return true;
+}
+
+bool FrameStats::writeCsv(const std::string &path) const {
+	std::ofstream out(path);
+	if (!out.is_open()) {
+		std::cerr << "Failed to open frame stats output: " << path << std::endl;
+		return false;
+	}
+
+	out << "phase,count,mean_ns,p50_ns,p99_ns,max_ns\n";
+	for (int i = 0; i < static_cast<int>(FramePhase::Count); ++i) {
+		const LatencyHistogram &h = _phases[i];
+		char line[256];
+		std::snprintf(line, sizeof(line), "%s,%llu,%.1f,%llu,%llu,%llu\n",
+			phaseName(static_cast<FramePhase>(i)), static_cast<unsigned long long>(h.getCount()), h.getMean(),
+			static_cast<unsigned long long>(h.getPercentile(0.50)), static_cast<unsigned long long>(h.getPercentile(0.99)),
+			static_cast<unsigned long long>(h.getMax()));
+		out << line;
+	}
+	// Tick counters ride along as rows with only a count
+	out << "ticks_run," << _ticks.run << ",,,,\n";
+	out << "ticks_dropped," << _ticks.dropped << ",,,,\n";
+	out << "dilated_frames," << _ticks.dilatedFrames << ",,,,\n";
+	return true;
+}
@@ -1,51 +1,274 @@
 #include "../incs/GameManager.hpp"
+#include "../incs/Tracer.hpp"
+#include "../incs/CellKernels.hpp"
+#include "../incs/Bot.hpp"
+#include "../incs/OccupancyGrid.hpp"
+#include <algorithm>
 
-GameManager::GameManager(GameState *state) : _state(state) {}
+GameManager::GameManager(GameState *state) : _state(state), _inputHead(0), _inputCount(0), _tick(0), _generation(0), _recorder(nullptr) {
+	_changes.clear();
+	_changes.fullRedraw = true;
+}
+
+void GameManager::update() {
+	update(std::chrono::steady_clock::time_point::max());
+}
 
-void GameManager::update()  {
+void GameManager::update(std::chrono::steady_clock::time_point tickTime) {
+	TRACE_SCOPE("tick");
+	takeArrivals(tickTime);
 	processNextInput();
-	_state->snake.move();
+
+	if (isCrowded()) {
+		updateCrowd();
+		_tick++;
+		return;
+	}
+
+	Snake &snake = _state->snake;
+	Cell tail = snake.getTailCell();
+	int length = snake.getLength();
+	Cell food = _state->food.getCell();
+	int score = _state->score;
+
+	snake.move();
 	_state->isRunning = checkGameOverCollision();
 	checkHeadFoodCollision();
+	_tick++;
+
+	// Once a full redraw is due nobody will read the lists, e.g. headless runs that never render
+	if (_changes.fullRedraw)
+		return;
+	_changes.addCell(snake.getHeadCell());
+	if (snake.getLength() == length)
+		_changes.freeCell(tail);
+	if (_state->food.getCell() != food)
+		_changes.moveFood(food);
+	if (_state->score != score)
+		_changes.scoreChanged = true;
+}
+
+bool GameManager::isCrowded() const {
+	return _state->snakes.size() > 1 || _state->foods.size() > 1;
+}
+
+void GameManager::buildArena(int width, int height, int snakeCount, int foodCount, OccupancyGrid &occupancy,
+	Rng &rng, std::vector<Snake> &snakes, std::vector<Food> &foods) {
+	if (snakeCount > 1 || foodCount > 1)
+		occupancy.enableOwners();
+	snakes.reserve(snakeCount);
+	foods.reserve(foodCount);
+	snakes.emplace_back(width, height, occupancy, rng);
+	foods.emplace_back(rng.getVec2(width - 1, height - 1), width, height, rng);
+	// Placeholders: populate() kills every bot before respawning any, so where these land never shows
+	Rng placeholder(0);
+	for (int i = 1; i < snakeCount; ++i)
+		snakes.emplace_back(width, height, occupancy, placeholder, i);
+	for (int i = 1; i < foodCount; ++i)
+		foods.emplace_back(Vec2{0, 0}, width, height, placeholder);
+}
+
+void GameManager::populate() {
+	if (!isCrowded())
+		return;
+
+	// Every bot leaves the grid before any spawns, so the first game sees the same free cells as a restart
+	std::span<Snake> snakes = _state->snakes;
+	for (size_t i = 1; i < snakes.size(); ++i)
+		snakes[i].kill();
+	for (size_t i = 1; i < snakes.size(); ++i)
+		snakes[i].respawn(_state->rng);
+	_dying.reserve(snakes.size() * 2);
+
+	_state->occupancy.setFoodAt(_state->food.getPosition(), 0);
+	for (size_t i = 1; i < _state->foods.size(); ++i)
+		placeFood(static_cast<int>(i));
+	markFullRedraw();
+}
+
+// Moves a food to a free cell no other food sits on and updates the food marks.
+// Returns false when the arena has no free cell left
+bool GameManager::placeFood(int index) {
+	Food &food = _state->foods[index];
+	OccupancyGrid &grid = _state->occupancy;
+	if (grid.getFoodAt(food.getPosition()) == index)
+		grid.setFoodAt(food.getPosition(), -1);
+
+	for (int attempt = 0; ; ++attempt) {
+		if (!food.replaceInFreeSpace(_state))
+			return false;
+		if (grid.getFoodAt(food.getPosition()) < 0)
+			break;
+		if (attempt == FOOD_ATTEMPTS) {
+			// Foods cover most of what is free: take the first free cell left over, if any
+			for (int n = 0; n < grid.getFreeCount(); ++n) {
+				if (grid.getFoodAt(grid.getFreeCell(n)) < 0) {
+					food.place(grid.getFreeCell(n), food.getFoodChar());
+					break;
+				}
+			}
+			break;
+		}
+	}
+
+	if (grid.getFoodAt(food.getPosition()) < 0)
+		grid.setFoodAt(food.getPosition(), index);
+	return true;
+}
+
+static void turn(Snake &snake, Input input) {
+	switch (input) {
+		case Input::Up:
+			snake.changeDirection(Direction::Up);
+			break;
+		case Input::Down:
+			snake.changeDirection(Direction::Down);
+			break;
+		case Input::Left:
+			snake.changeDirection(Direction::Left);
+			break;
+		case Input::Right:
+			snake.changeDirection(Direction::Right);
+			break;
+		default:
+			break;
+	}
+}
+
+// Every snake moves at once: all tails first, so a head may take the cell another tail just left, then all heads.
+// Deaths are settled once every head has moved, so two heads meeting on one cell both die whichever moved first
+void GameManager::updateCrowd() {
+	std::span<Snake> snakes = _state->snakes;
+	std::span<Food> foods = _state->foods;
+	OccupancyGrid &grid = _state->occupancy;
+	bool recording = !_changes.fullRedraw;
+
+	// Each bot chases its own food, so steering doesn't depend on how many foods there are
+	for (size_t i = 1; i < snakes.size(); ++i) {
+		if (snakes[i].isAlive())
+			turn(snakes[i], Bot::steer(snakes[i], foods[i % foods.size()].getPosition(), grid, _state->rng));
+	}
+
+	for (Snake &snake : snakes) {
+		if (!snake.isAlive())
+			continue;
+		int length = snake.getLength();
+		snake.moveTail();
+		if (recording && snake.getLength() < length)
+			_changes.freeCell(packCell(snake.getPreviousTail()));
+	}
+	for (Snake &snake : snakes) {
+		if (!snake.isAlive())
+			continue;
+		snake.moveHead();
+		if (recording)
+			_changes.addCell(snake.getHeadCell());
+	}
+
+	_dying.clear();
+	for (Snake &snake : snakes) {
+		if (!snake.isAlive())
+			continue;
+		Vec2 head = snake.getHead();
+		if (!grid.inBounds(head)) {
+			_dying.push_back(snake.getId());
+			continue;
+		}
+		if (!snake.isHeadOnBody()) {
+			int food = grid.getFoodAt(head);
+			if (food < 0)
+				continue;
+			snake.grow();
+			if (snake.getId() == 0) {
+				_state->score++;
+				_changes.scoreChanged = true;
+			}
+			if (!placeFood(food)) {
+				_state->isRunning = false;
+				std::cout << "YOU WIN" << std::endl;
+			}
+			if (recording)
+				_changes.addCell(foods[food].getCell());
+			continue;
+		}
+		_dying.push_back(snake.getId());
+		// The cell keeps whoever took it first; if that was a head too, it was a head-on crash
+		int first = grid.getSnakeAt(head);
+		if (first >= 0 && first != snake.getId() && snakes[first].getHeadCell() == snake.getHeadCell())
+			_dying.push_back(first);
+	}
+
+	for (int id : _dying) {
+		if (id == 0) {
+			_state->isRunning = false;
+			continue;
+		}
+		snakes[id].kill();
+		markFullRedraw();
+	}
+
+	// Bots come back as soon as there is room, whether they died now or earlier without finding any
+	for (size_t i = 1; i < snakes.size(); ++i) {
+		if (snakes[i].isAlive())
+			continue;
+		snakes[i].respawn(_state->rng);
+		if (snakes[i].isAlive())
+			markFullRedraw();
+	}
 }
 
+long GameManager::getTick() const { return _tick; }
+
+void GameManager::resetTick() {
+	_tick = 0;
+	_generation++;
+	markFullRedraw();
+}
+
+const ChangeSet &GameManager::getChanges() const { return _changes; }
+
+void GameManager::clearChanges() { _changes.clear(); }
+
+void GameManager::markFullRedraw() { _changes.fullRedraw = true; }
+
+void GameManager::setRecorder(ReplayRecorder *recorder) { _recorder = recorder; }
+
+// Unstamped inputs count as already arrived, whatever tick time they are checked against
 void GameManager::bufferInput(Input input) {
-	if (input >= Input::Up && input <= Input::Right) {
-		if (inputBuffer.size() < MAX_BUFFER_SIZE) {
-			inputBuffer.push(input);
+	bufferInput(input, std::chrono::steady_clock::time_point::min());
+}
+
+void GameManager::bufferInput(Input input, std::chrono::steady_clock::time_point time) {
+	if (input >= Input::Up && input <= Input::Right)
+		_arrivals.push(TimedInput{ input, time });
+}
+
+// Turns beyond what the buffer holds are dropped, as a full buffer always did
+void GameManager::takeArrivals(std::chrono::steady_clock::time_point tickTime) {
+	while (!_arrivals.empty() && _arrivals.peek().time <= tickTime) {
+		if (_inputCount < MAX_BUFFER_SIZE) {
+			_inputBuffer[(_inputHead + _inputCount) % MAX_BUFFER_SIZE] = _arrivals.peek().input;
+			_inputCount++;
 		}
+		_arrivals.pop();
 	}
 }
 
 void GameManager::processNextInput() {
-	if (!inputBuffer.empty()) {
-		Input input = inputBuffer.front();
-		inputBuffer.pop();
-		
-		switch (input) {
-			case Input::Up:
-				_state->snake.changeDirection(Direction::Up);
-				break;
-			case Input::Down:
-				_state->snake.changeDirection(Direction::Down);
-				break;
-			case Input::Left:
-				_state->snake.changeDirection(Direction::Left);
-				break;
-			case Input::Right:
-				_state->snake.changeDirection(Direction::Right);
-				break;
-			default:
-				break;
-		}
+	if (_inputCount > 0) {
+		Input input = _inputBuffer[_inputHead];
+		_inputHead = (_inputHead + 1) % MAX_BUFFER_SIZE;
+		_inputCount--;
+		Direction previous = _state->snake.getDirection();
+		turn(_state->snake, input);
+
+		if (_recorder && _state->snake.getDirection() != previous)
+			_recorder->recordTurn(_tick, input);
 	}
 }
 
 void GameManager::checkHeadFoodCollision() {
-	Vec2	head = _state->snake.getSegments()[0];
-	Vec2	foodPos = _state->food.getPosition();
-
-	if (head.x == foodPos.x && head.y == foodPos.y)
+	if (_state->snake.getHeadCell() == _state->food.getCell())
 	{
 		_state->snake.grow();
 		_state->score++;  // Increment score when food is eaten
@@ -60,24 +283,100 @@ void GameManager::checkHeadFoodCollision() {
 
 bool GameManager::checkGameOverCollision()
 {
-	Vec2	head = _state->snake.getSegments()[0];
+	Vec2	head = _state->snake.getHead();
 	if (head.x < 0 || head.x > _state->width - 1)
 		return false;
 
 	if (head.y < 0 || head.y > _state->height - 1)
 		return false;
 
-	for (int i = 1; i < _state->snake.getLength(); i++)
-	{
-		if (_state->snake.getSegments()[i].x == head.x && _state->snake.getSegments()[i].y == head.y)
-			return false;
-	}
+	// The occupancy bit for the head cell was tested as the snake moved into it
+	if (_state->snake.isHeadOnBody())
+		return false;
 
 	return true;
 }
 
 void GameManager::clearInputBuffer() {
-	while (!inputBuffer.empty()) {
-		inputBuffer.pop();
+	_arrivals.clear();
+	_inputHead = 0;
+	_inputCount = 0;
+}
+
+void GameManager::capture(GameSnapshot &snapshot) const {
+	const Snake &snake = _state->snake;
+
+	snapshot.segments.resize(snake.getLength());
+	for (int i = 0; i < snake.getLength(); ) {
+		std::span<const Cell> run = snake.getSegmentRun(i);
+		std::copy(run.begin(), run.end(), snapshot.segments.begin() + i);
+		i += run.size();
 	}
+	snapshot.previousHead = snake.getPreviousHead();
+	snapshot.previousTail = snake.getPreviousTail();
+	snapshot.direction = snake.getDirection();
+	snapshot.pendingGrowth = snake.getPendingGrowth();
+	snapshot.headOnBody = snake.isHeadOnBody();
+
+	snapshot.foodPosition = _state->food.getPosition();
+	snapshot.foodChar = _state->food.getFoodChar();
+	snapshot.score = _state->score;
+	snapshot.isRunning = _state->isRunning;
+	snapshot.tick = _tick;
+	snapshot.generation = _generation;
+	snapshot.rng = _state->rng.getState();
+
+	// Inputs still in the arrival queue are taken as if the next tick had already moved them over
+	snapshot.inputCount = _inputCount;
+	for (int i = 0; i < _inputCount; ++i)
+		snapshot.inputs[i] = _inputBuffer[(_inputHead + i) % MAX_BUFFER_SIZE];
+	size_t queued = _arrivals.size();
+	for (size_t i = 0; i < queued && snapshot.inputCount < MAX_BUFFER_SIZE; ++i)
+		snapshot.inputs[snapshot.inputCount++] = _arrivals.peek(i).input;
+}
+
+// A snapshot a few ticks ahead in the same game holds the current body shifted back by those ticks:
+// the new head cells come first, then the old body minus whatever the tail let go of. Anything else
+// (another game, a rewind, a head sitting on the body) falls back to a full redraw
+void GameManager::recordRestoreChanges(const GameSnapshot &snapshot) {
+	if (_changes.fullRedraw)
+		return;
+	const Snake &snake = _state->snake;
+	long advanced = snapshot.tick - _tick;
+	long kept = static_cast<long>(snapshot.segments.size()) - advanced;
+
+	if (snapshot.generation != _generation || advanced < 0 || advanced > ChangeSet::MAX_CELLS
+		|| kept < 0 || kept > snake.getLength()
+		|| CellKernels::find(snapshot.segments.data(), snapshot.segments.size(), snake.getHeadCell()) != static_cast<size_t>(advanced)) {
+		markFullRedraw();
+		return;
+	}
+
+	for (long i = 0; i < advanced; ++i)
+		_changes.addCell(snapshot.segments[i]);
+	for (long i = kept; i < snake.getLength(); ++i)
+		_changes.freeCell(packCell(snake.getSegment(i)));
+	if (packCell(snapshot.foodPosition) != _state->food.getCell())
+		_changes.moveFood(_state->food.getCell());
+	if (snapshot.score != _state->score)
+		_changes.scoreChanged = true;
+}
+
+void GameManager::restore(const GameSnapshot &snapshot) {
+	recordRestoreChanges(snapshot);
+	_state->snake.setBody(snapshot.segments, snapshot.direction, snapshot.pendingGrowth);
+	_state->snake.setPreviousEnds(snapshot.previousHead, snapshot.previousTail);
+	_state->snake.setHeadOnBody(snapshot.headOnBody);
+	_state->food.place(snapshot.foodPosition, snapshot.foodChar);
+	_state->score = snapshot.score;
+	_state->isRunning = snapshot.isRunning;
+	_state->rng.setState(snapshot.rng);
+	_tick = snapshot.tick;
+	_generation = snapshot.generation;
+
+	_arrivals.clear();
+	_inputHead = 0;
+	_inputCount = snapshot.inputCount;
+	for (int i = 0; i < _inputCount; ++i)
+		_inputBuffer[i] = snapshot.inputs[i];
 }
\ No newline at end of file
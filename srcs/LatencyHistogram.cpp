@@ -0,0 +1,65 @@
+#include "../incs/LatencyHistogram.hpp"
+#include <algorithm>
+#include <bit>
+
+LatencyHistogram::LatencyHistogram() {
+	reset();
+}
+
+// Values below SUB_BUCKETS get a bucket each; above that, the top SUB_BUCKET_BITS bits
+// after the leading one pick the sub-bucket within the value's power of two
+int LatencyHistogram::bucketFor(uint64_t value) {
+	if (value < static_cast<uint64_t>(SUB_BUCKETS))
+		return static_cast<int>(value);
+
+	int shift = std::bit_width(value) - SUB_BUCKET_BITS - 1;
+	return (shift + 1) * SUB_BUCKETS + static_cast<int>((value >> shift) - SUB_BUCKETS);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(int bucket) {
+	if (bucket < SUB_BUCKETS)
+		return static_cast<uint64_t>(bucket);
+
+	int shift = (bucket / SUB_BUCKETS) - 1;
+	uint64_t lower = static_cast<uint64_t>(SUB_BUCKETS + (bucket % SUB_BUCKETS)) << shift;
+	return lower + ((uint64_t(1) << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds) {
+	_counts[bucketFor(nanoseconds)]++;
+	_total++;
+	_sum += nanoseconds;
+	_max = std::max(_max, nanoseconds);
+}
+
+void LatencyHistogram::reset() {
+	std::fill(_counts, _counts + BUCKET_COUNT, 0);
+	_total = 0;
+	_sum = 0;
+	_max = 0;
+}
+
+uint64_t LatencyHistogram::getCount() const { return _total; }
+
+uint64_t LatencyHistogram::getMax() const { return _max; }
+
+double LatencyHistogram::getMean() const {
+	return _total ? static_cast<double>(_sum) / _total : 0.0;
+}
+
+uint64_t LatencyHistogram::getPercentile(double quantile) const {
+	if (_total == 0)
+		return 0;
+
+	uint64_t rank = static_cast<uint64_t>(quantile * _total);
+	if (rank >= _total)
+		rank = _total - 1;
+
+	uint64_t seen = 0;
+	for (int bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+		seen += _counts[bucket];
+		if (seen > rank)
+			return std::min(bucketUpperBound(bucket), _max);
+	}
+	return _max;
+}
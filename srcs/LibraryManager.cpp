@@ -1,45 +1,359 @@
 #include "../incs/LibraryManager.hpp"
+#include "../incs/Tracer.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sys/inotify.h>
+#include <unistd.h>
 
-LibraryManager::LibraryManager() : handle(nullptr), graphic(nullptr) {}
-
-LibraryManager::~LibraryManager() { unload(); }
-
-bool LibraryManager::load(const char * libPath) {
-	handle = dlopen(libPath, RTLD_NOW);
-			if (!handle) {
-				std::cerr << "dlopen error: " << dlerror() << std::endl;
-				return false;
-			}
-			
-			CreateFn create = (CreateFn)dlsym(handle, "createGraphic");
-			DestroyFn destroy = (DestroyFn)dlsym(handle, "destroyGraphic");
-			
-			if (!create || !destroy) {
-				std::cerr << "Symbol error: " << dlerror() << std::endl;
-				dlclose(handle);
-				handle = nullptr;
-				return false;
-			}
-			
-			graphic = create();
-			std::cout << "Loaded: " << libPath << std::endl;
-			return true;
+LibraryManager::LibraryManager() : active(0), resident(false), warmingStale(false), warmWidth(0), warmHeight(0), stopping(false),
+	hotReload(false), watchFd(-1) {}
+
+LibraryManager::~LibraryManager() {
+	{
+		std::lock_guard<std::mutex> lock(warmMutex);
+		stopping = true;
+		warmQueue.clear();
+	}
+	warmChanged.notify_all();
+	if (warmer.joinable())
+		warmer.join();
+	for (Plugin &plugin : warmed)
+		close(plugin);
+	unload();
+	if (watchFd >= 0)
+		::close(watchFd);
 }
 
-void LibraryManager::unload() {
-	if (graphic) {
-		using DestroyFn = void (*)(IGraphic*);
-		DestroyFn destroy = (DestroyFn)dlsym(handle, "destroyGraphic");
+// Reports failures through error rather than std::cerr: the worker must not write over a terminal
+// that the active backend is drawing on
+bool LibraryManager::open(const char *libPath, Plugin &plugin, std::string &error) {
+	TRACE_SCOPE("dlopen");
+	std::string copyPath;
+	if (hotReload && !copyForReload(libPath, copyPath, error))
+		return false;
+	plugin.handle = dlopen(hotReload ? copyPath.c_str() : libPath, RTLD_NOW);
+	// The mapping outlives the file, so the copy can go straight away
+	if (hotReload)
+		unlink(copyPath.c_str());
+	if (!plugin.handle) {
+		error = std::string("dlopen error: ") + dlerror();
+		return false;
+	}
+
+	DescriptorFn describe = (DescriptorFn)dlsym(plugin.handle, "getGraphicDescriptor");
+	plugin.descriptor = describe ? describe() : nullptr;
+	if (!plugin.descriptor || plugin.descriptor->abiVersion != GRAPHIC_ABI_VERSION) {
+		error = std::string("Plugin error: ") + libPath + (plugin.descriptor
+			? " was built for graphics ABI " + std::to_string(plugin.descriptor->abiVersion)
+			: std::string(" has no graphics descriptor"))
+			+ ", this build needs ABI " + std::to_string(GRAPHIC_ABI_VERSION);
+		dlclose(plugin.handle);
+		plugin.handle = nullptr;
+		plugin.descriptor = nullptr;
+		return false;
+	}
+
+	CreateFn create = (CreateFn)dlsym(plugin.handle, "createGraphic");
+	DestroyFn destroy = (DestroyFn)dlsym(plugin.handle, "destroyGraphic");
+
+	if (!create || !destroy) {
+		error = std::string("Symbol error: ") + dlerror();
+		dlclose(plugin.handle);
+		plugin.handle = nullptr;
+		plugin.descriptor = nullptr;
+		return false;
+	}
+
+	plugin.graphic = create();
+	return true;
+}
+
+void LibraryManager::close(Plugin &plugin) {
+	if (plugin.graphic) {
+		DestroyFn destroy = (DestroyFn)dlsym(plugin.handle, "destroyGraphic");
 		if (destroy) {
-			destroy(graphic);
+			destroy(plugin.graphic);
 		}
-		graphic = nullptr;
+		plugin.graphic = nullptr;
 	}
 
-	if (handle) {
-		dlclose(handle);
-		handle = nullptr;
+	if (plugin.handle) {
+		dlclose(plugin.handle);
+		plugin.handle = nullptr;
+	}
+	plugin.descriptor = nullptr;
+}
+
+// The new plugin is opened before the old one goes, so a refused one leaves the game with a backend
+bool LibraryManager::load(const char *libPath) {
+	Plugin plugin = { libPath, nullptr, nullptr, nullptr };
+	bool warm = takeWarm(libPath, plugin);
+	if (!warm) {
+		std::string error;
+		if (!open(libPath, plugin, error)) {
+			std::cerr << error << std::endl;
+			return false;
+		}
+	}
+	std::cout << "Loaded: " << libPath << " (" << plugin.descriptor->name << ", ABI " << plugin.descriptor->abiVersion
+		<< (warm ? ", pre-warmed)" : ")") << std::endl;
+	unload();
+	plugins.push_back(plugin);
+	if (hotReload)
+		watch(plugin.path);
+	return true;
+}
+
+// A plugin the worker hasn't started on is opened here rather than waited for; one it is working on
+// right now is waited for, since that's the quickest way to get it
+bool LibraryManager::takeWarm(const char *libPath, Plugin &plugin) {
+	std::unique_lock<std::mutex> lock(warmMutex);
+	warmQueue.erase(std::remove(warmQueue.begin(), warmQueue.end(), libPath), warmQueue.end());
+	{
+		TRACE_SCOPE("prewarm_wait");
+		warmChanged.wait(lock, [&] { return warming != libPath; });
 	}
+	// The worker queues it again if it was rebuilt while being opened
+	warmQueue.erase(std::remove(warmQueue.begin(), warmQueue.end(), libPath), warmQueue.end());
+	auto found = std::find_if(warmed.begin(), warmed.end(), [&](const Plugin &p) { return p.path == libPath; });
+	if (found == warmed.end())
+		return false;
+	plugin = *found;
+	warmed.erase(found);
+	return true;
+}
+
+void LibraryManager::prewarm(std::span<const std::string_view> libPaths, int width, int height) {
+	std::lock_guard<std::mutex> lock(warmMutex);
+	warmWidth = width;
+	warmHeight = height;
+	for (std::string_view path : libPaths) {
+		auto samePath = [&](const Plugin &p) { return p.path == path; };
+		if (std::any_of(plugins.begin(), plugins.end(), samePath) || std::any_of(warmed.begin(), warmed.end(), samePath)
+			|| path == warming || std::find(warmQueue.begin(), warmQueue.end(), path) != warmQueue.end())
+			continue;
+		warmQueue.emplace_back(path);
+		if (hotReload)
+			watch(warmQueue.back());
+	}
+	if (!warmer.joinable())
+		warmer = std::thread(&LibraryManager::warmLoop, this);
+	warmChanged.notify_all();
+}
+
+// A plugin that fails to open here is dropped quietly; load() tries again and reports the error
+void LibraryManager::warmLoop() {
+	Tracer::setThreadName("prewarm");
+	std::unique_lock<std::mutex> lock(warmMutex);
+	while (true) {
+		warmChanged.wait(lock, [this] { return stopping || !warmQueue.empty(); });
+		if (stopping)
+			return;
+		warming = warmQueue.front();
+		warmQueue.pop_front();
+		warmingStale = false;
+		Plugin plugin = { warming, nullptr, nullptr, nullptr };
+		int width = warmWidth;
+		int height = warmHeight;
+		lock.unlock();
+
+		std::string error;
+		bool opened = open(plugin.path.c_str(), plugin, error);
+		if (opened && (plugin.descriptor->capabilities & GRAPHIC_CAP_PREWARM)) {
+			TRACE_SCOPE("plugin_prewarm");
+			plugin.graphic->prewarm(width, height);
+		}
+
+		lock.lock();
+		if (warmingStale) {
+			if (opened)
+				close(plugin);
+			warmQueue.push_back(warming);
+		} else if (opened)
+			warmed.push_back(plugin);
+		warming.clear();
+		warmChanged.notify_all();
+	}
+}
+
+void LibraryManager::unload() {
+	TRACE_SCOPE("unload");
+	for (Plugin &plugin : plugins)
+		close(plugin);
+	plugins.clear();
+	active = 0;
+	resident = false;
+}
+
+bool LibraryManager::loadResident(std::span<const std::string_view> libPaths, size_t first, int width, int height) {
+	unload();
+	for (size_t i = 0; i < libPaths.size(); ++i) {
+		Plugin plugin = { std::string(libPaths[i]), nullptr, nullptr, nullptr };
+		std::string error;
+		if (!open(libPaths[i].data(), plugin, error)) {
+			std::cerr << error << std::endl;
+			unload();
+			return false;
+		}
+		std::cout << "Loaded: " << libPaths[i] << " (" << plugin.descriptor->name << ", ABI "
+			<< plugin.descriptor->abiVersion << ")" << std::endl;
+		plugins.push_back(plugin);
+		{
+			TRACE_SCOPE("plugin_init");
+			plugin.graphic->init(width, height);
+		}
+		if (i != first)
+			plugin.graphic->suspend();
+	}
+
+	resident = true;
+	active = first;
+	// The last backend initialized may have taken over the screen or the focus
+	get()->resume();
+	return true;
 }
 
-IGraphic *LibraryManager::get() { return graphic; }
\ No newline at end of file
+void LibraryManager::activate(size_t index) {
+	if (!resident || index == active || index >= plugins.size())
+		return;
+	plugins[active].graphic->suspend();
+	active = index;
+	plugins[active].graphic->resume();
+}
+
+bool LibraryManager::isResident() const { return resident; }
+
+IGraphic *LibraryManager::get() { return plugins.empty() ? nullptr : plugins[active].graphic; }
+
+bool LibraryManager::supports(uint32_t capability) const {
+	return !plugins.empty() && (plugins[active].descriptor->capabilities & capability);
+}
+
+// -=-=-=-=-    HOT RELOAD -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- //
+
+static std::string directoryOf(const std::string &path) {
+	size_t slash = path.rfind('/');
+	if (slash == std::string::npos)
+		return ".";
+	return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+static std::string fileNameOf(const std::string &path) {
+	size_t slash = path.rfind('/');
+	return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+bool LibraryManager::enableHotReload() {
+	watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (watchFd < 0) {
+		std::cerr << "inotify error: " << std::strerror(errno) << std::endl;
+		return false;
+	}
+	hotReload = true;
+	return true;
+}
+
+// dlopen() hands back whatever is already loaded under the same name, and C++ plugins often can't be
+// unloaded at all, so every load gets a path of its own
+bool LibraryManager::copyForReload(const std::string &libPath, std::string &copyPath, std::string &error) {
+	char pattern[] = "/tmp/nibbler_hot_XXXXXX.so";
+	int fd = mkstemps(pattern, 3);
+	if (fd < 0) {
+		error = std::string("Hot reload error: ") + std::strerror(errno);
+		return false;
+	}
+	::close(fd);
+	copyPath = pattern;
+
+	std::ifstream source(libPath, std::ios::binary);
+	std::ofstream copy(copyPath, std::ios::binary | std::ios::trunc);
+	if (source.is_open())
+		copy << source.rdbuf();
+	copy.close();
+	if (!source.is_open() || !copy) {
+		unlink(copyPath.c_str());
+		error = "Hot reload error: can't copy " + libPath + " to " + copyPath;
+		return false;
+	}
+	return true;
+}
+
+// The directory is watched rather than the file: a linker or installer may replace the file outright
+void LibraryManager::watch(const std::string &libPath) {
+	std::string directory = directoryOf(libPath);
+	for (const auto &watched : watchedDirs) {
+		if (watched.second == directory)
+			return;
+	}
+	int wd = inotify_add_watch(watchFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+	if (wd < 0) {
+		std::cerr << "inotify error on " << directory << ": " << std::strerror(errno) << std::endl;
+		return;
+	}
+	watchedDirs.emplace_back(wd, directory);
+}
+
+bool LibraryManager::isWatched(const std::string &libPath, int wd, const char *name) const {
+	std::string directory = directoryOf(libPath);
+	for (const auto &watched : watchedDirs) {
+		if (watched.first == wd && watched.second == directory)
+			return fileNameOf(libPath) == name;
+	}
+	return false;
+}
+
+// A warm copy of a rebuilt plugin is stale; it is dropped and queued again
+void LibraryManager::rewarm(int wd, const char *name) {
+	std::lock_guard<std::mutex> lock(warmMutex);
+	// The worker may be opening the old build right now; it requeues the path once it's done
+	if (!warming.empty() && isWatched(warming, wd, name))
+		warmingStale = true;
+	for (auto plugin = warmed.begin(); plugin != warmed.end(); ) {
+		if (!isWatched(plugin->path, wd, name)) {
+			++plugin;
+			continue;
+		}
+		warmQueue.push_back(plugin->path);
+		close(*plugin);
+		plugin = warmed.erase(plugin);
+	}
+	warmChanged.notify_all();
+}
+
+bool LibraryManager::reloadIfChanged() {
+	if (watchFd < 0 || plugins.empty())
+		return false;
+
+	alignas(inotify_event) char buffer[4096];
+	bool changed = false;
+	ssize_t length;
+	while ((length = read(watchFd, buffer, sizeof(buffer))) > 0) {
+		for (ssize_t offset = 0; offset < length; ) {
+			const inotify_event *event = reinterpret_cast<const inotify_event*>(buffer + offset);
+			offset += sizeof(inotify_event) + event->len;
+			if (!event->len)
+				continue;
+			if (isWatched(plugins[active].path, event->wd, event->name))
+				changed = true;
+			else
+				rewarm(event->wd, event->name);
+		}
+	}
+	if (!changed)
+		return false;
+
+	TRACE_SCOPE("hot_reload");
+	Plugin fresh = { plugins[active].path, nullptr, nullptr, nullptr };
+	std::string error;
+	if (!open(fresh.path.c_str(), fresh, error)) {
+		std::cerr << error << std::endl;
+		return false;
+	}
+	close(plugins[active]);
+	plugins[active] = fresh;
+	std::cout << "Reloaded: " << fresh.path << " (" << fresh.descriptor->name << ", ABI "
+		<< fresh.descriptor->abiVersion << ")" << std::endl;
+	return true;
+}
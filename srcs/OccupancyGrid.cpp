@@ -0,0 +1,166 @@
+#include "../incs/OccupancyGrid.hpp"
+#include <algorithm>
+#include <bit>
+
+OccupancyGrid::OccupancyGrid(int width, int height) : _width(width), _height(height), _occupied(0),
+	_bits((static_cast<size_t>(width) * height + 63) / 64, 0), _freeTree(_bits.size() + 1, 0) {
+	_treeTop = static_cast<int>(std::bit_floor(_bits.size()));
+	clear();
+}
+
+// The last word may run past the end of the arena; those bits are never free cells
+uint64_t OccupancyGrid::validMask(size_t word) const {
+	size_t cells = static_cast<size_t>(_width) * _height;
+	size_t used = cells - (word * 64);
+	return (used >= 64) ? ~uint64_t(0) : (uint64_t(1) << used) - 1;
+}
+
+void OccupancyGrid::addFree(size_t word, int delta) {
+	for (size_t i = word + 1; i < _freeTree.size(); i += i & (~i + 1))
+		_freeTree[i] += delta;
+}
+
+void OccupancyGrid::occupy(Vec2 cell, int owner) {
+	testAndOccupy(cell, owner);
+}
+
+void OccupancyGrid::release(Vec2 cell, int owner) {
+	if (!inBounds(cell))
+		return;
+
+	int idx = index(cell);
+	if (hasOwners()) {
+		if (_snakeOwners[idx] != owner + 1)
+			return;
+		_snakeOwners[idx] = 0;
+	}
+	uint64_t mask = uint64_t(1) << (idx & 63);
+	if (_bits[idx >> 6] & mask) {
+		_bits[idx >> 6] &= ~mask;
+		_occupied--;
+		addFree(idx >> 6, 1);
+	}
+}
+
+// Returns whether the cell was already taken before marking it
+bool OccupancyGrid::testAndOccupy(Vec2 cell, int owner) {
+	if (!inBounds(cell))
+		return false;
+
+	int idx = index(cell);
+	uint64_t mask = uint64_t(1) << (idx & 63);
+	if (_bits[idx >> 6] & mask)
+		return true;
+
+	_bits[idx >> 6] |= mask;
+	_occupied++;
+	addFree(idx >> 6, -1);
+	if (hasOwners())
+		_snakeOwners[idx] = owner + 1;
+	return false;
+}
+
+void OccupancyGrid::clear() {
+	std::fill(_bits.begin(), _bits.end(), 0);
+	std::fill(_snakeOwners.begin(), _snakeOwners.end(), 0);
+	std::fill(_foodOwners.begin(), _foodOwners.end(), 0);
+	rebuildTree();
+}
+
+// Owners are only written from now on, so this goes before anything is placed
+void OccupancyGrid::enableOwners() {
+	if (hasOwners())
+		return;
+	_snakeOwners.assign(static_cast<size_t>(_width) * _height, 0);
+	_foodOwners.assign(static_cast<size_t>(_width) * _height, 0);
+}
+
+void OccupancyGrid::setFoodAt(Vec2 cell, int food) {
+	if (hasOwners() && inBounds(cell))
+		_foodOwners[index(cell)] = food + 1;
+}
+
+// Linear-time Fenwick build: every node pushes its total up to its parent once.
+// Recounts the occupied cells on the way, so the bulk paths can flip bits without tracking them.
+void OccupancyGrid::rebuildTree() {
+	int freeCount = 0;
+	for (size_t i = 1; i < _freeTree.size(); ++i) {
+		_freeTree[i] = std::popcount(~_bits[i - 1] & validMask(i - 1));
+		freeCount += _freeTree[i];
+	}
+	_occupied = (_width * _height) - freeCount;
+	for (size_t i = 1; i < _freeTree.size(); ++i) {
+		size_t parent = i + (i & (~i + 1));
+		if (parent < _freeTree.size())
+			_freeTree[parent] += _freeTree[i];
+	}
+}
+
+// A rebuild touches every word once, a per-cell update about log2(words) tree nodes
+static bool preferRebuild(size_t cells, size_t words) {
+	return cells * std::bit_width(words) > words;
+}
+
+// With owners on, every cell needs its owner checked or written, so the bulk paths are skipped
+void OccupancyGrid::occupyAll(const SegmentStore &cells, int owner) {
+	if (hasOwners() || !preferRebuild(cells.size(), _bits.size())) {
+		for (int i = 0; i < cells.size(); ++i)
+			testAndOccupy(unpackCell(cells[i]), owner);
+		return;
+	}
+
+	for (int i = 0; i < cells.size(); ++i) {
+		Vec2 cell = unpackCell(cells[i]);
+		if (inBounds(cell)) {
+			int idx = index(cell);
+			_bits[idx >> 6] |= uint64_t(1) << (idx & 63);
+		}
+	}
+	rebuildTree();
+}
+
+void OccupancyGrid::releaseAll(const SegmentStore &cells, int owner) {
+	if (hasOwners() || !preferRebuild(cells.size(), _bits.size())) {
+		for (int i = 0; i < cells.size(); ++i)
+			release(unpackCell(cells[i]), owner);
+		return;
+	}
+
+	for (int i = 0; i < cells.size(); ++i) {
+		Vec2 cell = unpackCell(cells[i]);
+		if (inBounds(cell)) {
+			int idx = index(cell);
+			_bits[idx >> 6] &= ~(uint64_t(1) << (idx & 63));
+		}
+	}
+	rebuildTree();
+}
+
+Vec2 OccupancyGrid::getFreeCell(int n) const {
+	// Walk down the tree to the word holding the n-th free cell
+	size_t word = 0;
+	uint32_t rank = static_cast<uint32_t>(n);
+	for (size_t step = _treeTop; step > 0; step >>= 1) {
+		if (word + step < _freeTree.size() && _freeTree[word + step] <= rank) {
+			word += step;
+			rank -= _freeTree[word];
+		}
+	}
+
+	// Then halve the word until only the rank-th free bit is left
+	uint64_t freeBits = ~_bits[word] & validMask(word);
+	int bit = 0;
+	for (int half = 32; half > 0; half >>= 1) {
+		uint64_t low = freeBits & ((uint64_t(1) << half) - 1);
+		uint32_t count = std::popcount(low);
+		if (rank >= count) {
+			rank -= count;
+			freeBits >>= half;
+			bit += half;
+		} else
+			freeBits = low;
+	}
+
+	int idx = static_cast<int>(word * 64) + bit;
+	return Vec2{ idx % _width, idx / _width };
+}
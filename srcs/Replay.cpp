@@ -0,0 +1,181 @@
+#include "../incs/Replay.hpp"
+#include "../incs/DataStructs.hpp"
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+
+static const char		REPLAY_MAGIC[4] = { 'N', 'B', 'R', 'P' };
+static const uint8_t	REPLAY_VERSION = 3;
+// Same layout minus the snake and food counts
+static const uint8_t	REPLAY_VERSION_SINGLE = 2;
+
+// -=-=-=-=-    RECORDER -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- //
+
+ReplayRecorder::ReplayRecorder(const char *path, int width, int height, int snakes, int foods) :
+	_file(path, std::ios::binary | std::ios::trunc), _lastTick(0), _inGame(false) {
+	if (!_file.is_open()) {
+		std::cerr << "Failed to open replay file for writing: " << path << std::endl;
+		return;
+	}
+
+	_file.write(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+	_file.put(static_cast<char>(REPLAY_VERSION));
+	writeVarint(width);
+	writeVarint(height);
+	writeVarint(snakes);
+	writeVarint(foods);
+	flush();
+}
+
+ReplayRecorder::~ReplayRecorder() {
+	flush();
+}
+
+bool ReplayRecorder::isOpen() const { return _file.is_open(); }
+
+bool ReplayRecorder::isInGame() const { return _inGame; }
+
+void ReplayRecorder::writeVarint(uint64_t value) {
+	while (value >= 0x80) {
+		_buffer.push_back(static_cast<uint8_t>(value) | 0x80);
+		value >>= 7;
+	}
+	_buffer.push_back(static_cast<uint8_t>(value));
+}
+
+void ReplayRecorder::flush() {
+	if (_buffer.empty() || !_file.is_open())
+		return;
+	_file.write(reinterpret_cast<const char *>(_buffer.data()), _buffer.size());
+	_file.flush();
+	_buffer.clear();
+}
+
+void ReplayRecorder::beginGame(uint64_t seed) {
+	writeVarint(seed);
+	_lastTick = 0;
+	_inGame = true;
+}
+
+void ReplayRecorder::recordTurn(long tick, Input input) {
+	if (!_inGame)
+		return;
+
+	uint64_t delta = static_cast<uint64_t>(tick - _lastTick);
+	uint64_t direction = static_cast<uint64_t>(static_cast<int>(input) - static_cast<int>(Input::Up));
+	writeVarint(((delta + 1) << 2) | direction);
+	_lastTick = tick;
+}
+
+void ReplayRecorder::endGame(long ticks, int score, bool finished) {
+	if (!_inGame)
+		return;
+
+	writeVarint(0);
+	writeVarint(ticks);
+	writeVarint(score);
+	_buffer.push_back(finished ? 1 : 0);
+	_inGame = false;
+
+	// Whole games only ever reach the disk, so a crash mid-game still leaves a valid file
+	flush();
+}
+
+// -=-=-=-=-    PLAYER -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- //
+
+static bool readVarint(const std::vector<uint8_t> &data, size_t &pos, uint64_t &value) {
+	value = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		if (pos >= data.size())
+			return false;
+		uint8_t byte = data[pos++];
+		value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+			return true;
+	}
+	return false;
+}
+
+ReplayPlayer::ReplayPlayer() : _width(0), _height(0), _snakes(1), _foods(1) {}
+
+bool ReplayPlayer::load(const char *path) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		std::cerr << "Failed to open replay file: " << path << std::endl;
+		return false;
+	}
+	std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	if (data.size() < 5 || !std::equal(REPLAY_MAGIC, REPLAY_MAGIC + 4, data.begin()) || (data[4] != REPLAY_VERSION && data[4] != REPLAY_VERSION_SINGLE)) {
+		std::cerr << "Not a nibbler replay (or an unsupported version): " << path << std::endl;
+		return false;
+	}
+
+	size_t pos = 5;
+	uint64_t width, height;
+	if (!readVarint(data, pos, width) || !readVarint(data, pos, height)) {
+		std::cerr << "Truncated replay header: " << path << std::endl;
+		return false;
+	}
+	if (width < 16 || height < 16 || width > MAX_ARENA_SIDE || height > MAX_ARENA_SIDE) {
+		std::cerr << "Replay arena size out of range (" << width << "x" << height << "): " << path << std::endl;
+		return false;
+	}
+	_width = static_cast<int>(width);
+	_height = static_cast<int>(height);
+
+	uint64_t snakes = 1, foods = 1;
+	if (data[4] == REPLAY_VERSION && (!readVarint(data, pos, snakes) || !readVarint(data, pos, foods))) {
+		std::cerr << "Truncated replay header: " << path << std::endl;
+		return false;
+	}
+	if (snakes < 1 || foods < 1 || snakes > MAX_SNAKES || foods > MAX_FOODS) {
+		std::cerr << "Replay snake or food count out of range (" << snakes << ", " << foods << "): " << path << std::endl;
+		return false;
+	}
+	_snakes = static_cast<int>(snakes);
+	_foods = static_cast<int>(foods);
+
+	_games.clear();
+	while (pos < data.size()) {
+		ReplayGame game = {};
+		uint64_t value;
+		if (!readVarint(data, pos, game.seed)) {
+			std::cerr << "Truncated replay game: " << path << std::endl;
+			return false;
+		}
+
+		long tick = 0;
+		while (true) {
+			if (!readVarint(data, pos, value)) {
+				std::cerr << "Truncated replay events: " << path << std::endl;
+				return false;
+			}
+			if (value == 0)
+				break;
+			tick += static_cast<long>(value >> 2) - 1;
+			game.events.push_back({ tick, static_cast<Input>(static_cast<int>(Input::Up) + static_cast<int>(value & 3)) });
+		}
+
+		uint64_t ticks, score;
+		if (!readVarint(data, pos, ticks) || !readVarint(data, pos, score) || pos >= data.size()) {
+			std::cerr << "Truncated replay trailer: " << path << std::endl;
+			return false;
+		}
+		game.ticks = static_cast<long>(ticks);
+		game.score = static_cast<int>(score);
+		game.finished = data[pos++] != 0;
+		_games.push_back(std::move(game));
+	}
+	return true;
+}
+
+int ReplayPlayer::getWidth() const { return _width; }
+
+int ReplayPlayer::getHeight() const { return _height; }
+
+int ReplayPlayer::getSnakeCount() const { return _snakes; }
+
+int ReplayPlayer::getFoodCount() const { return _foods; }
+
+const std::vector<ReplayGame> &ReplayPlayer::getGames() const { return _games; }
@@ -0,0 +1,65 @@
+#include "../incs/Rng.hpp"
+#include <random>
+
+Rng::Rng() {
+	seed(randomSeed());
+}
+
+Rng::Rng(uint64_t seed) {
+	this->seed(seed);
+}
+
+void Rng::seed(uint64_t seed) {
+	for (uint64_t &word : _state) {
+		seed += 0x9E3779B97F4A7C15ULL;
+		uint64_t z = seed;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		word = z ^ (z >> 31);
+	}
+}
+
+Rng::State Rng::getState() const {
+	return State{ { _state[0], _state[1], _state[2], _state[3] } };
+}
+
+void Rng::setState(const State &state) {
+	for (int i = 0; i < 4; ++i)
+		_state[i] = state.words[i];
+}
+
+int Rng::getInt(int max) {
+	if (max <= 0)
+		return 0;
+
+	// Lemire's multiply-shift: no modulo bias, and the division only runs on the rare rejection path
+	const uint32_t range = static_cast<uint32_t>(max) + 1;
+	uint64_t product = (next() >> 32) * range;
+	uint32_t low = static_cast<uint32_t>(product);
+	if (low < range) {
+		const uint32_t threshold = -range % range;
+		while (low < threshold) {
+			product = (next() >> 32) * range;
+			low = static_cast<uint32_t>(product);
+		}
+	}
+	return static_cast<int>(product >> 32);
+}
+
+int Rng::getRangeInt(int min, int max) {
+	return min + getInt(max - min);
+}
+
+Vec2 Rng::getVec2(int xMax, int yMax) {
+	return Vec2{ getInt(xMax - 1), getInt(yMax - 1) };
+}
+
+float Rng::getFloat() {
+	// Top 24 bits fill the float mantissa exactly
+	return static_cast<float>(next() >> 40) * (1.0f / 16777216.0f);
+}
+
+uint64_t Rng::randomSeed() {
+	std::random_device rd;
+	return (static_cast<uint64_t>(rd()) << 32) ^ rd();
+}
@@ -0,0 +1,125 @@
+#include "../incs/SegmentStore.hpp"
+#include "../incs/CellKernels.hpp"
+#include <algorithm>
+
+SegmentStore::SegmentStore() : _map(4, nullptr), _firstChunk(0), _chunkCount(0), _front(0), _length(0) {}
+
+SegmentStore::SegmentStore(const SegmentStore &other) : SegmentStore() {
+	*this = other;
+}
+
+// Copies the segments only; spare chunks stay with their owner
+SegmentStore &SegmentStore::operator=(const SegmentStore &other) {
+	if (this == &other)
+		return *this;
+	clear();
+	for (int i = 0; i < other._length; ) {
+		std::span<const Cell> segments = other.run(i);
+		for (Cell segment : segments)
+			push_back(segment);
+		i += segments.size();
+	}
+	return *this;
+}
+
+SegmentStore::~SegmentStore() {
+	for (size_t i = 0; i < _chunkCount; ++i)
+		delete[] chunk(i);
+	for (Cell *spare : _spare)
+		delete[] spare;
+}
+
+Cell *SegmentStore::takeChunk() {
+	if (_spare.empty())
+		return new Cell[CHUNK_SIZE];
+	Cell *reused = _spare.back();
+	_spare.pop_back();
+	return reused;
+}
+
+// Unrolls the ring into a map twice the size, live chunks first
+void SegmentStore::growMap() {
+	std::vector<Cell*> grown(_map.size() * 2, nullptr);
+	for (size_t i = 0; i < _chunkCount; ++i)
+		grown[i] = chunk(i);
+	_map.swap(grown);
+	_firstChunk = 0;
+}
+
+std::span<const Cell> SegmentStore::run(int index) const {
+	int pos = _front + index;
+	int count = std::min(_length - index, CHUNK_SIZE - (pos & CHUNK_MASK));
+	return std::span<const Cell>(chunk(pos >> CHUNK_SHIFT) + (pos & CHUNK_MASK), count);
+}
+
+void SegmentStore::push_front(Cell segment) {
+	if (_front == 0) {
+		if (_chunkCount == _map.size())
+			growMap();
+		_firstChunk = (_firstChunk - 1) & (_map.size() - 1);
+		_map[_firstChunk] = takeChunk();
+		_chunkCount++;
+		_front = CHUNK_SIZE;
+	}
+	_front--;
+	_length++;
+	chunk(0)[_front] = segment;
+}
+
+void SegmentStore::push_back(Cell segment) {
+	int pos = _front + _length;
+	if (pos == static_cast<int>(_chunkCount) * CHUNK_SIZE)
+		appendChunk();
+	_length++;
+	chunk(pos >> CHUNK_SHIFT)[pos & CHUNK_MASK] = segment;
+}
+
+void SegmentStore::pop_back() {
+	_length--;
+	if (_length == 0) {
+		clear();
+		return;
+	}
+	// The last chunk is empty once the end falls back onto a chunk boundary
+	if (_front + _length == static_cast<int>(_chunkCount - 1) * CHUNK_SIZE) {
+		_spare.push_back(chunk(_chunkCount - 1));
+		_chunkCount--;
+	}
+}
+
+void SegmentStore::clear() {
+	for (size_t i = 0; i < _chunkCount; ++i)
+		_spare.push_back(chunk(i));
+	_chunkCount = 0;
+	_firstChunk = 0;
+	_front = 0;
+	_length = 0;
+}
+
+Cell *SegmentStore::appendChunk() {
+	if (_chunkCount == _map.size())
+		growMap();
+	Cell *target = takeChunk();
+	chunk(_chunkCount) = target;
+	_chunkCount++;
+	return target;
+}
+
+// Both assign() overloads fill whole chunks at a time, so copies and conversions run over long stretches
+void SegmentStore::assign(std::span<const Cell> segments) {
+	clear();
+	for (size_t done = 0; done < segments.size(); done += CHUNK_SIZE) {
+		size_t count = std::min(segments.size() - done, static_cast<size_t>(CHUNK_SIZE));
+		std::copy(segments.begin() + done, segments.begin() + done + count, appendChunk());
+	}
+	_length = static_cast<int>(segments.size());
+}
+
+void SegmentStore::assign(std::span<const Vec2> segments) {
+	clear();
+	for (size_t done = 0; done < segments.size(); done += CHUNK_SIZE) {
+		size_t count = std::min(segments.size() - done, static_cast<size_t>(CHUNK_SIZE));
+		CellKernels::pack(segments.data() + done, count, appendChunk());
+	}
+	_length = static_cast<int>(segments.size());
+}
@@ -0,0 +1,119 @@
+#include "../incs/SimulationThread.hpp"
+#include "../incs/Tracer.hpp"
+#include <algorithm>
+
+SimulationThread::SimulationThread(GameManager &manager, GameState &state, double tickSeconds, double maxCatchUpSeconds)
+	: _manager(manager), _state(state),
+	_tickLength(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(tickSeconds))),
+	_maxCatchUp(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(maxCatchUpSeconds))),
+	_finished(false), _started(false), _command(Command::Park), _active(false), _counters{ 0, 0, 0 } {}
+
+SimulationThread::~SimulationThread() {
+	if (!_thread.joinable())
+		return;
+	{
+		std::lock_guard<std::mutex> lock(_controlMutex);
+		_command = Command::Exit;
+	}
+	_control.notify_all();
+	_thread.join();
+}
+
+// Publishes the current state first, so the render side has something to draw before the first tick
+void SimulationThread::start() {
+	if (_started)
+		return;
+	_manager.capture(_snapshots.back().snapshot);
+	_snapshots.back().time = std::chrono::steady_clock::now();
+	_snapshots.publish();
+	_finished.store(false, std::memory_order_relaxed);
+	_started = true;
+
+	{
+		std::lock_guard<std::mutex> lock(_controlMutex);
+		_command = Command::Run;
+	}
+	_control.notify_all();
+	if (!_thread.joinable())
+		_thread = std::thread(&SimulationThread::run, this);
+}
+
+void SimulationThread::stop() {
+	if (!_started)
+		return;
+	{
+		std::unique_lock<std::mutex> lock(_controlMutex);
+		if (_command == Command::Run)
+			_command = Command::Park;
+		_control.notify_all();
+		_control.wait(lock, [this] { return !_active && _command == Command::Park; });
+	}
+	_started = false;
+}
+
+bool SimulationThread::isRunning() const {
+	return _started;
+}
+
+bool SimulationThread::hasFinished() const {
+	return _finished.load(std::memory_order_acquire);
+}
+
+TickCounters SimulationThread::getTickCounters() {
+	std::lock_guard<std::mutex> lock(_controlMutex);
+	return _counters;
+}
+
+bool SimulationThread::acquireLatest() {
+	return _snapshots.update();
+}
+
+const GameSnapshot &SimulationThread::latest() const {
+	return _snapshots.front().snapshot;
+}
+
+float SimulationThread::getInterpolation(std::chrono::steady_clock::time_point now) const {
+	double alpha = std::chrono::duration<double>(now - _snapshots.front().time) / _tickLength;
+	return static_cast<float>(std::clamp(alpha, 0.0, 1.0));
+}
+
+// Ticks are scheduled against absolute deadlines, so a late wakeup doesn't push every later tick back
+void SimulationThread::run() {
+	Tracer::setThreadName("simulation");
+	std::unique_lock<std::mutex> lock(_controlMutex);
+
+	while (true) {
+		_active = false;
+		_control.notify_all();
+		_control.wait(lock, [this] { return _command != Command::Park; });
+		if (_command == Command::Exit)
+			return;
+		_active = true;
+
+		auto deadline = std::chrono::steady_clock::now() + _tickLength;
+		while (!_control.wait_until(lock, deadline, [this] { return _command != Command::Run; })) {
+			lock.unlock();
+			_manager.update(deadline);
+			_manager.capture(_snapshots.back().snapshot);
+			_snapshots.back().time = deadline;
+			_snapshots.publish();
+			lock.lock();
+			deadline += _tickLength;
+			_counters.run++;
+
+			auto late = std::chrono::steady_clock::now() - deadline;
+			if (late > _maxCatchUp) {
+				long long missed = late / _tickLength;
+				_counters.dropped += missed;
+				_counters.dilatedFrames++;
+				deadline += missed * _tickLength;
+			}
+
+			if (!_state.isRunning) {
+				_finished.store(true, std::memory_order_release);
+				if (_command == Command::Run)
+					_command = Command::Park;
+			}
+		}
+	}
+}
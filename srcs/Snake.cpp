@@ -1,10 +1,24 @@
 #include "../incs/Snake.hpp"
 #include <iostream>
+#include <algorithm>
 
-Snake::Snake(int width, int height): _length(4), _maxLength((width * height) - 2) {
-	_segments = new Vec2[_maxLength];
-	
-	switch (Utils::getRandomInt(3))
+Snake::Snake(int width, int height, OccupancyGrid &occupancy, Rng &rng, int id): _maxLength((width * height) - 2), _pendingGrowth(0),
+	_occupancy(&occupancy), _id(id), _alive(true), _headOnBody(false) {
+	spawn(rng);
+}
+
+void Snake::respawn(Rng &rng) {
+	_pendingGrowth = 0;
+	_headOnBody = false;
+	spawn(rng);
+}
+
+// A fresh four-cell body at a random spot, without touching the occupancy grid
+void Snake::layOut(Rng &rng) {
+	int width = _occupancy->getWidth();
+	int height = _occupancy->getHeight();
+
+	switch (rng.getInt(3))
 	{
 		case 0:
 			_direction = Direction::Up;
@@ -20,78 +34,87 @@ Snake::Snake(int width, int height): _length(4), _maxLength((width * height) - 2
 			break;
 	}
 
-	Vec2 headPosition = { Utils::getRandomRangeInt(8, width - 8), Utils::getRandomRangeInt(8, height - 8) };
+	Vec2 headPosition = { rng.getRangeInt(8, width - 8), rng.getRangeInt(8, height - 8) };
+	Vec2 step = { 0, 0 };
 
 	switch (_direction) {
 		case Direction::Up:
-			_segments[0] = headPosition;
-			_segments[1] = { headPosition.x, headPosition.y + 1 };
-			_segments[2] = { headPosition.x, headPosition.y + 2 };
-			_segments[3] = { headPosition.x, headPosition.y + 3 };
+			step.y = 1;
 			break;
 
 		case Direction::Down:
-			_segments[0] = headPosition;
-			_segments[1] = { headPosition.x, headPosition.y - 1 };
-			_segments[2] = { headPosition.x, headPosition.y - 2 };
-			_segments[3] = { headPosition.x, headPosition.y - 3 };
+			step.y = -1;
 			break;
 
 		case Direction::Left:
-			_segments[0] = headPosition;
-			_segments[1] = { headPosition.x + 1, headPosition.y };
-			_segments[2] = { headPosition.x + 2, headPosition.y };
-			_segments[3] = { headPosition.x + 3, headPosition.y };
+			step.x = 1;
 			break;
 
 		case Direction::Right:
-			_segments[0] = headPosition;
-			_segments[1] = { headPosition.x - 1, headPosition.y };
-			_segments[2] = { headPosition.x - 2, headPosition.y };
-			_segments[3] = { headPosition.x - 3, headPosition.y };
+			step.x = -1;
 			break;
 	}
-}
 
-Snake::Snake(const Snake &other) : _length(other._length), _maxLength(other._maxLength) {
-	_segments = new Vec2[_maxLength];
-	_direction = other._direction;
-	for (int i = 0; i < _length; ++i) {
-		_segments[i] = other._segments[i];
-	}
+	_segments.clear();
+	for (int i = 0; i < 4; ++i)
+		_segments.push_back(packCell({ headPosition.x + (step.x * i), headPosition.y + (step.y * i) }));
+
+	_previousHead = getHead();
+	_previousTail = getTail();
 }
 
-Snake &Snake::operator=(const Snake &other) {
-	if (this != &other)
-	{
-		delete[] _segments;
-		
-		this->_length = other._length;
-		this->_maxLength = other._maxLength;
-		this->_direction = other._direction;
-		this->_segments = new Vec2[_maxLength];
-		
-		for (int i = 0; i < this->_length; ++i)
-			this->_segments[i] = other._segments[i];
+void Snake::spawn(Rng &rng) {
+	if (_id == 0) {
+		layOut(rng);
+		_occupancy->clear();
+	} else {
+		_alive = false;
+		for (int attempt = 0; attempt < SPAWN_ATTEMPTS && !_alive; ++attempt) {
+			layOut(rng);
+			_alive = true;
+			for (int i = 0; i < getLength() && _alive; ++i)
+				_alive = _occupancy->isFree(getSegment(i));
+		}
+		if (!_alive)
+			return;
 	}
-	return *this;
+
+	_alive = true;
+	for (int i = 0; i < getLength(); ++i)
+		_occupancy->occupy(getSegment(i), _id);
 }
 
-Snake::~Snake() {
-	delete[] _segments;
+void Snake::kill() {
+	if (_alive)
+		_occupancy->releaseAll(_segments, _id);
+	_alive = false;
 }
 
-int Snake::getLength() const { return _length; }
+int Snake::getId() const { return _id; }
 
-const Vec2 *Snake::getSegments() const { return _segments; }
+bool Snake::isAlive() const { return _alive; }
+
+int Snake::getLength() const { return _segments.size(); }
+
+Vec2 Snake::getSegment(int index) const { return unpackCell(_segments[index]); }
+
+Vec2 Snake::getHead() const { return unpackCell(_segments[0]); }
+
+Vec2 Snake::getTail() const { return unpackCell(_segments[_segments.size() - 1]); }
+
+Cell Snake::getHeadCell() const { return _segments[0]; }
+
+Cell Snake::getTailCell() const { return _segments[_segments.size() - 1]; }
+
+std::span<const Cell> Snake::getSegmentRun(int index) const { return _segments.run(index); }
+
+Snake::const_iterator Snake::begin() const { return const_iterator(this, 0); }
+
+Snake::const_iterator Snake::end() const { return const_iterator(this, getLength()); }
+
+Vec2 Snake::getNextHead() const {
+	Vec2 head = getHead();
 
-void Snake::move(){
-	auto head = _segments[0];
-	Vec2 previousPositions[_length];
-	for (int i = 0; i < _length; i++) {
-		previousPositions[i] = _segments[i];
-	}
-	
 	switch (_direction)
 	{
 		case Direction::Left:
@@ -110,18 +133,72 @@ void Snake::move(){
 			head.y++;
 			break;
 	}
+	return head;
+}
 
-	_segments[0] = head;
+// Moving is "push new head, pop tail"; pending growth keeps the tail instead
+void Snake::move() {
+	moveTail();
+	moveHead();
+}
 
-	for (int i = 1; i < _length; ++i)
-	{
-		Vec2 newPos;
-		newPos.x = previousPositions[i - 1].x;
-		newPos.y = previousPositions[i - 1].y;
-		_segments[i] = newPos;
+void Snake::moveTail() {
+	_previousHead = getHead();
+	_previousTail = getTail();
+
+	if (_pendingGrowth > 0) {
+		_pendingGrowth--;
+	} else {
+		_occupancy->release(getTail(), _id);
+		_segments.pop_back();
 	}
 }
 
+void Snake::moveHead() {
+	Vec2 head = getNextHead();
+	_segments.push_front(packCell(head));
+	_headOnBody = _occupancy->testAndOccupy(head, _id);
+}
+
+bool Snake::isHeadOnBody() const { return _headOnBody; }
+
+Direction Snake::getDirection() const { return _direction; }
+
+int Snake::getPendingGrowth() const { return _pendingGrowth; }
+
+const Vec2 &Snake::getPreviousHead() const { return _previousHead; }
+
+const Vec2 &Snake::getPreviousTail() const { return _previousTail; }
+
+void Snake::setBody(std::span<const Vec2> body, Direction dir, int pendingGrowth) {
+	_occupancy->releaseAll(_segments, _id);
+	_segments.assign(body.first(std::min(body.size(), static_cast<size_t>(_maxLength))));
+	bodyReplaced(dir, pendingGrowth);
+}
+
+void Snake::setBody(std::span<const Cell> body, Direction dir, int pendingGrowth) {
+	_occupancy->releaseAll(_segments, _id);
+	_segments.assign(body.first(std::min(body.size(), static_cast<size_t>(_maxLength))));
+	bodyReplaced(dir, pendingGrowth);
+}
+
+void Snake::bodyReplaced(Direction dir, int pendingGrowth) {
+	_pendingGrowth = pendingGrowth;
+	_headOnBody = false;
+	_direction = dir;
+
+	_occupancy->occupyAll(_segments, _id);
+	_previousHead = getHead();
+	_previousTail = getTail();
+}
+
+void Snake::setPreviousEnds(Vec2 head, Vec2 tail) {
+	_previousHead = head;
+	_previousTail = tail;
+}
+
+void Snake::setHeadOnBody(bool headOnBody) { _headOnBody = headOnBody; }
+
 void Snake::changeDirection(Direction dir) { 
 	if ((_direction == Direction::Up && dir == Direction::Down)
 		|| (_direction == Direction::Down && dir == Direction::Up)
@@ -135,11 +212,10 @@ void Snake::changeDirection(Direction dir) {
 };
 
 void Snake::grow() {
-	if (_length >= _maxLength) {
+	if (getLength() + _pendingGrowth >= _maxLength) {
 		// Snake has filled the entire arena - this is a win condition!
 		return;
 	}
-	_segments[_length] = Vec2{ _segments[_length - 1].x, _segments[_length - 1].y };
-	_length++;
+	// The new segment shows up on the next move, when the tail stays put instead of being popped
+	_pendingGrowth++;
 }
-	
@@ -0,0 +1,54 @@
+#include "../incs/TickScheduler.hpp"
+#include <algorithm>
+
+TickScheduler::TickScheduler(double tickSeconds, double maxCatchUpSeconds)
+	: _tickLength(tickSeconds), _maxCatchUp(std::max(1, static_cast<int>(maxCatchUpSeconds / tickSeconds))),
+	_turbo(0), _accumulator(0.0), _due(0), _counters{ 0, 0, 0 } {}
+
+void TickScheduler::setTurbo(int ticksPerFrame) { _turbo = std::max(0, ticksPerFrame); }
+
+bool TickScheduler::isTurbo() const { return _turbo > 0; }
+
+void TickScheduler::reset() {
+	_accumulator = 0.0;
+	_due = 0;
+}
+
+void TickScheduler::advance(double elapsedSeconds) {
+	if (_turbo > 0) {
+		_due = _turbo;
+		return;
+	}
+
+	_accumulator += elapsedSeconds;
+	int due = static_cast<int>(_accumulator / _tickLength);
+	if (due > _maxCatchUp) {
+		_counters.dropped += due - _maxCatchUp;
+		_counters.dilatedFrames++;
+		_accumulator -= (due - _maxCatchUp) * _tickLength;
+		due = _maxCatchUp;
+	}
+	_due = due;
+}
+
+bool TickScheduler::takeTick() {
+	if (_due == 0)
+		return false;
+	_due--;
+	if (_turbo == 0)
+		_accumulator -= _tickLength;
+	_counters.run++;
+	return true;
+}
+
+double TickScheduler::getAlpha() const {
+	if (_turbo > 0)
+		return 1.0;
+	return std::clamp(_accumulator / _tickLength, 0.0, 1.0);
+}
+
+double TickScheduler::getTimeToNextTick() const {
+	return std::max(0.0, _tickLength - _accumulator);
+}
+
+const TickCounters &TickScheduler::getCounters() const { return _counters; }
@@ -0,0 +1,94 @@
+#include "../incs/Tracer.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+std::atomic<bool>							Tracer::_enabled(false);
+size_t										Tracer::_capacity = Tracer::DEFAULT_CAPACITY;
+std::mutex									Tracer::_registryMutex;
+std::vector<std::unique_ptr<Tracer::ThreadBuffer>>	Tracer::_buffers;
+
+static std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+
+void Tracer::enable(size_t eventsPerThread) {
+	_capacity = eventsPerThread ? eventsPerThread : DEFAULT_CAPACITY;
+	g_epoch = std::chrono::steady_clock::now();
+	_enabled.store(true, std::memory_order_release);
+}
+
+uint64_t Tracer::now() {
+	return fromClock(std::chrono::steady_clock::now());
+}
+
+uint64_t Tracer::fromClock(std::chrono::steady_clock::time_point time) {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(time - g_epoch).count();
+}
+
+// Each thread registers its buffer on first use; the registry keeps it alive after the thread exits
+Tracer::ThreadBuffer *Tracer::local() {
+	thread_local ThreadBuffer *buffer = nullptr;
+	if (!buffer) {
+		auto owned = std::make_unique<ThreadBuffer>();
+		owned->events.resize(_capacity);
+		owned->written.store(0, std::memory_order_relaxed);
+
+		std::lock_guard<std::mutex> lock(_registryMutex);
+		owned->tid = static_cast<int>(_buffers.size()) + 1;
+		owned->name = "thread " + std::to_string(owned->tid);
+		buffer = owned.get();
+		_buffers.push_back(std::move(owned));
+	}
+	return buffer;
+}
+
+void Tracer::record(const char *name, uint64_t start, uint64_t end) {
+	ThreadBuffer *buffer = local();
+	uint64_t slot = buffer->written.load(std::memory_order_relaxed);
+	buffer->events[slot % buffer->events.size()] = TraceEvent{ name, start, end - start };
+	buffer->written.store(slot + 1, std::memory_order_release);
+}
+
+void Tracer::setThreadName(const std::string &name) {
+	if (!isEnabled())
+		return;
+	ThreadBuffer *buffer = local();
+	std::lock_guard<std::mutex> lock(_registryMutex);
+	buffer->name = name;
+}
+
+bool Tracer::write(const std::string &path) {
+	std::ofstream out(path);
+	if (!out.is_open()) {
+		std::cerr << "Failed to open trace output: " << path << std::endl;
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(_registryMutex);
+	out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+
+	bool first = true;
+	char line[256];
+	for (const auto &buffer : _buffers) {
+		std::snprintf(line, sizeof(line),
+			"%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": \"%s\"}}",
+			first ? "" : ",\n", buffer->tid, buffer->name.c_str());
+		out << line;
+		first = false;
+
+		// Only the newest events survive once the ring has wrapped
+		uint64_t written = buffer->written.load(std::memory_order_acquire);
+		uint64_t capacity = buffer->events.size();
+		uint64_t begin = (written > capacity) ? written - capacity : 0;
+		for (uint64_t i = begin; i < written; ++i) {
+			const TraceEvent &event = buffer->events[i % capacity];
+			std::snprintf(line, sizeof(line),
+				",\n{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}",
+				event.name, buffer->tid, event.start / 1000.0, event.duration / 1000.0);
+			out << line;
+		}
+	}
+
+	out << "\n]}\n";
+	return true;
+}
@@ -0,0 +1,266 @@
+#include "../incs/Snake.hpp"
+#include "../incs/Food.hpp"
+#include "../incs/OccupancyGrid.hpp"
+#include "../incs/DataStructs.hpp"
+#include "../incs/GameManager.hpp"
+#include "../incs/GameSnapshot.hpp"
+#include "../incs/CellKernels.hpp"
+#include "../incs/Rng.hpp"
+#include "../incs/colors.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+/*
+Micro-benchmarks for the game core hot path.
+Every case runs on an arena of each size with the snake laid out along a Hamiltonian cycle
+(row 0 left to right, a serpentine over columns 1..W-1, back up column 0), covering the requested
+fraction of the cells. Following that cycle lets the snake move forever without dying, so the
+numbers measure steady-state ticks rather than setup.
+Results go to stdout and, as JSON, to the file given on the command line.
+*/
+
+// -=-=-=-=-    ALLOCATION COUNTING -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- //
+
+static long g_allocations = 0;
+
+void *operator new(std::size_t size) {
+	g_allocations++;
+	if (void *ptr = std::malloc(size ? size : 1))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+// -=-=-=-=-    ARENA SETUP -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- //
+
+static Direction cycleDirection(Vec2 cell, int width, int height) {
+	if (cell.y == 0)
+		return (cell.x < width - 1) ? Direction::Right : Direction::Down;
+	if (cell.x == 0)
+		return Direction::Up;
+	if (cell.y % 2 == 1) {
+		if (cell.x > 1 || cell.y == height - 1)
+			return Direction::Left;
+		return Direction::Down;
+	}
+	return (cell.x < width - 1) ? Direction::Right : Direction::Down;
+}
+
+static Vec2 stepCell(Vec2 cell, Direction dir) {
+	switch (dir) {
+		case Direction::Left:	cell.x--; break;
+		case Direction::Right:	cell.x++; break;
+		case Direction::Up:		cell.y--; break;
+		case Direction::Down:	cell.y++; break;
+	}
+	return cell;
+}
+
+struct Arena {
+	int				width;
+	int				height;
+	Rng				rng;
+	OccupancyGrid	occupancy;
+	Snake			snake;
+	Food			food;
+	GameState		state;
+	GameManager		manager;
+
+	Arena(int w, int h, double fill) : width(w), height(h), rng(42), occupancy(w, h), snake(w, h, occupancy, rng),
+		food(Vec2{0, 0}, w, h, rng),
+		state{ w, h, snake, food, occupancy, rng, false, true, false, GameStateType::Playing, 0, std::span<Snake>(&snake, 1), std::span<Food>(&food, 1) },
+		manager(&state) {
+		long cells = static_cast<long>(w) * h;
+		long length = std::max(4L, std::min(static_cast<long>(fill * cells), cells - 2));
+
+		// Walk the cycle from (0,0); the last cell reached is the head
+		std::vector<Vec2> body(length);
+		Vec2 cell = {0, 0};
+		for (long i = length - 1; i >= 0; --i) {
+			body[i] = cell;
+			cell = stepCell(cell, cycleDirection(cell, w, h));
+		}
+		snake.setBody(body, cycleDirection(body[0], w, h));
+
+		// Park the food on a free cell away from the head so the food check takes the common miss path
+		food = Food(occupancy.getFreeCell(0), w, h, rng);
+	}
+
+	void advance() {
+		snake.changeDirection(cycleDirection(snake.getHead(), width, height));
+		snake.move();
+	}
+};
+
+// -=-=-=-=-    RUNNER -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- //
+
+struct Result {
+	std::string	name;
+	int			width;
+	int			height;
+	double		fill;
+	long		iterations;
+	double		nsPerOp;
+	double		allocsPerOp;
+};
+
+static volatile long g_sink = 0;
+
+// Runs op in growing batches until minSeconds have been spent or maxIterations are done
+template <typename Op>
+static Result run(const char *name, const Arena &arena, double fill, long maxIterations, Op op) {
+	const double minSeconds = 0.05;
+
+	long iterations = 0;
+	long allocations = 0;
+	double seconds = 0.0;
+	long batch = 1;
+
+	while (seconds < minSeconds && iterations < maxIterations) {
+		batch = std::min(batch, maxIterations - iterations);
+
+		long allocsBefore = g_allocations;
+		auto start = std::chrono::steady_clock::now();
+		for (long i = 0; i < batch; ++i)
+			op();
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		allocations += g_allocations - allocsBefore;
+
+		seconds += elapsed.count();
+		iterations += batch;
+		batch *= 2;
+	}
+
+	Result result = { name, arena.width, arena.height, fill, iterations,
+		(seconds * 1e9) / iterations, static_cast<double>(allocations) / iterations };
+
+	std::printf("%-40s %5dx%-5d fill %.2f  %12.1f ns/op  %6.2f allocs/op  (%ld iterations)\n",
+		result.name.c_str(), result.width, result.height, result.fill,
+		result.nsPerOp, result.allocsPerOp, result.iterations);
+	return result;
+}
+
+static void benchArena(int size, double fill, std::vector<Result> &results) {
+	Arena arena(size, size, fill);
+	const long unbounded = 50000000;
+
+	results.push_back(run("Snake::move", arena, fill, unbounded, [&]() {
+		arena.advance();
+	}));
+
+	// Every op adds a segment, so stop well before the arena fills up
+	{
+		Arena growArena(size, size, fill);
+		long room = std::max(1L, (static_cast<long>(size) * size - growArena.snake.getLength()) / 2);
+		results.push_back(run("Snake::grow", growArena, fill, room, [&]() {
+			growArena.snake.grow();
+			growArena.advance();
+		}));
+	}
+
+	results.push_back(run("GameManager::checkGameOverCollision", arena, fill, unbounded, [&]() {
+		g_sink = g_sink + arena.manager.checkGameOverCollision();
+	}));
+
+	results.push_back(run("GameManager::checkHeadFoodCollision", arena, fill, unbounded, [&]() {
+		arena.manager.checkHeadFoodCollision();
+	}));
+
+	results.push_back(run("Food::replaceInFreeSpace", arena, fill, unbounded, [&]() {
+		g_sink = g_sink + arena.food.replaceInFreeSpace(&arena.state);
+	}));
+
+	// Warm the snapshot up once so the timed loop measures steady-state copies
+	GameSnapshot snapshot;
+	arena.manager.capture(snapshot);
+
+	results.push_back(run("GameManager::capture", arena, fill, unbounded, [&]() {
+		arena.manager.capture(snapshot);
+	}));
+
+	results.push_back(run("GameManager::restore", arena, fill, unbounded, [&]() {
+		arena.manager.restore(snapshot);
+	}));
+
+	// The kernels behind restore()'s redraw check and setBody(), at every SIMD level this CPU has.
+	// The find is a full scan, since the food is never on the body
+	std::vector<Vec2> body(arena.snake.begin(), arena.snake.end());
+	std::vector<Cell> packed(body.size());
+	for (int level = 0; level <= static_cast<int>(CellKernels::getSupportedLevel()); ++level) {
+		CellKernels::setLevel(static_cast<SimdLevel>(level));
+		std::string suffix = std::string(" [") + CellKernels::getLevelName(CellKernels::getLevel()) + "]";
+
+		results.push_back(run(("CellKernels::find" + suffix).c_str(), arena, fill, unbounded, [&]() {
+			g_sink = g_sink + CellKernels::find(snapshot.segments.data(), snapshot.segments.size(), arena.food.getCell());
+		}));
+
+		results.push_back(run(("CellKernels::pack" + suffix).c_str(), arena, fill, unbounded, [&]() {
+			CellKernels::pack(body.data(), body.size(), packed.data());
+		}));
+	}
+	CellKernels::setLevel(CellKernels::getSupportedLevel());
+}
+
+static bool writeJson(const char *path, const std::vector<Result> &results) {
+	std::ofstream out(path);
+	if (!out.is_open()) {
+		std::cerr << "Failed to open benchmark output: " << path << std::endl;
+		return false;
+	}
+
+	out << "{\n  \"benchmarks\": [\n";
+	for (size_t i = 0; i < results.size(); ++i) {
+		const Result &r = results[i];
+		char line[512];
+		std::snprintf(line, sizeof(line),
+			"    {\"name\": \"%s\", \"width\": %d, \"height\": %d, \"fill\": %.2f, "
+			"\"iterations\": %ld, \"ns_per_op\": %.3f, \"allocs_per_op\": %.4f}%s\n",
+			r.name.c_str(), r.width, r.height, r.fill, r.iterations, r.nsPerOp, r.allocsPerOp,
+			(i + 1 < results.size()) ? "," : "");
+		out << line;
+	}
+	out << "  ]\n}\n";
+	return true;
+}
+
+int main(int argc, char **argv) {
+	const char *outputPath = "bench_results.json";
+	int maxSize = 4096;
+
+	for (int i = 1; i < argc; ++i) {
+		if (!std::strcmp(argv[i], "--max-size") && i + 1 < argc)
+			maxSize = std::stoi(argv[++i]);
+		else if (argv[i][0] != '-')
+			outputPath = argv[i];
+		else {
+			std::cerr << BYEL << "Usage: ./nibbler_bench [output.json] [--max-size N]" << RESET << std::endl;
+			return 1;
+		}
+	}
+
+	const int sizes[] = { 16, 64, 256, 1024, 4096 };
+	const double fills[] = { 0.10, 0.50, 0.90 };
+
+	std::vector<Result> results;
+	for (int size : sizes) {
+		if (size > maxSize)
+			break;
+		for (double fill : fills)
+			benchArena(size, fill, results);
+	}
+
+	if (!writeJson(outputPath, results))
+		return 1;
+
+	std::cout << BGRN << "[Bench] " << results.size() << " results written to " << outputPath << RESET << std::endl;
+	return 0;
+}
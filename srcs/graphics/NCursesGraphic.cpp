@@ -1,6 +1,7 @@
 #include "../../incs/NCursesGraphic.hpp"
 
-NCursesGraphic::NCursesGraphic() : width(0), height(0), gameWindow(nullptr), isInitialized(false) {}
+NCursesGraphic::NCursesGraphic() : width(0), height(0), gameWindow(nullptr), isInitialized(false),
+	isPrewarmed(false), fullRedraw(true) {}
 
 NCursesGraphic::~NCursesGraphic() {
 	if (!isInitialized) {
@@ -33,7 +34,7 @@ NCursesGraphic::~NCursesGraphic() {
 bool NCursesGraphic::loadAsciiArtFile(const std::string& filepath, AsciiArtFile& art) {
 	std::ifstream file(filepath);
 	if (!file.is_open()) {
-		std::cerr << "Failed to load ASCII art file: " << filepath << std::endl;
+		missingLogos.push_back(filepath);
 		return false;
 	}
 	
@@ -91,6 +92,7 @@ if (has_colors()) {
 	init_pair(3, COLOR_BLACK, COLOR_BLACK);   // Background
 	init_pair(4, COLOR_WHITE, COLOR_BLACK);   // UI text
 	init_pair(5, COLOR_GREEN, COLOR_BLACK);   // Ground
+	init_pair(6, COLOR_MAGENTA, COLOR_BLACK); // Bot snakes
 	
 	bkgd(COLOR_PAIR(0));
 	clear();
@@ -110,7 +112,21 @@ if (has_colors()) {
 		nodelay(gameWindow, TRUE);
 	}
 	
+	if (!isPrewarmed)
+		prewarm(w, h);
+	for (const std::string &path : missingLogos)
+		std::cerr << "Failed to load ASCII art file: " << path << std::endl;
+	missingLogos.clear();
+	
+	isInitialized = true;
+}
+
+// Ground pattern and logos need no terminal, so they can be ready before the switch to this backend
+void NCursesGraphic::prewarm(int w, int h) {
+	width = w;
+	height = h;
 	generateGroundPattern();
+	missingLogos.clear();
 	
 	// Load ASCII art files once during initialization
 	loadAsciiArtFile("logos/ncurses_title_small_A.txt", titleSmallA);
@@ -124,29 +140,61 @@ if (has_colors()) {
 	loadAsciiArtFile("logos/ncurses_gameover_small.txt", gameoverSmall);
 	loadAsciiArtFile("logos/ncurses_gameover_big.txt", gameoverBig);
 	
-	isInitialized = true;
+	isPrewarmed = true;
+}
+
+void NCursesGraphic::applyChanges(const ChangeSet &changes) {
+	if (changes.fullRedraw) {
+		fullRedraw = true;
+		return;
+	}
+	dirtyCells.insert(dirtyCells.end(), changes.added, changes.added + changes.addedCount);
+	dirtyCells.insert(dirtyCells.end(), changes.freed, changes.freed + changes.freedCount);
+	if (changes.foodMoved)
+		dirtyCells.push_back(changes.previousFood);
 }
 
 void NCursesGraphic::render(const GameState& state, float deltaTime) {
 	(void)deltaTime;
 
-	werase(gameWindow);
-	
-	int win_height, win_width;
-	getmaxyx(gameWindow, win_height, win_width);
-	
-	drawGround();
-
-	drawBorder();
-	
-	drawSnake(state);
-	
-	drawFood(state);
+	if (fullRedraw) {
+		werase(gameWindow);
+		drawGround();
+		drawBorder();
+		// Bots first, so the player ends up on top wherever a head ran into someone
+		for (size_t i = state.snakes.size(); i-- > 0; ) {
+			if (state.snakes[i].isAlive())
+				drawSnake(state.snakes[i]);
+		}
+		for (const Food &food : state.foods)
+			drawFood(food);
+		fullRedraw = false;
+	} else {
+		// Anything that touched stdscr would hide the window on refresh unless all of it is sent again
+		if (is_wintouched(stdscr))
+			touchwin(gameWindow);
+		for (Cell cell : dirtyCells)
+			drawCell(state, unpackCell(cell));
+		for (Vec2 head : drawnHeads)
+			drawCell(state, head);
+		// Heads and tails change glyph as they move on, and foods are few
+		for (const Snake &snake : state.snakes) {
+			if (!snake.isAlive())
+				continue;
+			drawCell(state, snake.getHead());
+			drawCell(state, snake.getTail());
+		}
+		for (const Food &food : state.foods)
+			drawCell(state, food.getPosition());
+	}
+	dirtyCells.clear();
+	drawnHeads.resize(state.snakes.size());
+	for (size_t i = 0; i < state.snakes.size(); ++i)
+		drawnHeads[i] = state.snakes[i].getHead();
 	
 	// Double buffer: stage stdscr first, then gameWindow
 	wnoutrefresh(stdscr);
 	wnoutrefresh(gameWindow);
-	doupdate();
 }
 
 void NCursesGraphic::drawTitle(int win_height, int win_width)
@@ -296,6 +344,7 @@ void NCursesGraphic::renderMenu(const GameState &state, float deltaTime) {
 	(void)deltaTime;
 	
 	werase(gameWindow);
+	fullRedraw = true;
 
 	int win_height, win_width;
 	getmaxyx(gameWindow, win_height, win_width);
@@ -317,7 +366,6 @@ void NCursesGraphic::renderMenu(const GameState &state, float deltaTime) {
 	
 	wnoutrefresh(stdscr);
 	wnoutrefresh(gameWindow);
-	doupdate();
 }
 
 void NCursesGraphic::drawGameOverTitle(int win_height, int win_width)
@@ -418,6 +466,7 @@ void NCursesGraphic::renderGameOver(const GameState &state, float deltaTime)
 {
 	(void)deltaTime;
 	werase(gameWindow);
+	fullRedraw = true;
 
 	int win_height, win_width;
 	getmaxyx(gameWindow, win_height, win_width);
@@ -438,9 +487,28 @@ void NCursesGraphic::renderGameOver(const GameState &state, float deltaTime)
 
 	wnoutrefresh(stdscr);
 	wnoutrefresh(gameWindow);
+}
+
+void NCursesGraphic::present() {
 	doupdate();
 }
 
+int NCursesGraphic::getInputFd() const {
+	return fileno(stdin);
+}
+
+// Hands the terminal back as it was, with the game window's contents kept for resume()
+void NCursesGraphic::suspend() {
+	endwin();
+}
+
+// The first refresh() after endwin() restores curses mode; keys typed meanwhile belonged to another backend
+void NCursesGraphic::resume() {
+	refresh();
+	flushinp();
+	fullRedraw = true;
+}
+
 Input NCursesGraphic::pollInput() {
 	int ch = getch();
 	switch (ch) {
@@ -463,21 +531,65 @@ Input NCursesGraphic::pollInput() {
 
 void NCursesGraphic::drawGround() {
 	wattron(gameWindow, COLOR_PAIR(5) | A_DIM);
-	for (int y = 4; y <= height + 3; ++y) {
-		for (int x = 0; x <= width; ++x) {
-			int screenX = (x * 2) + 4;
-			char groundChar = groundPattern[y - 4][x];
-			if (groundChar != ' ') {
-				mvwaddch(gameWindow, y, screenX, groundChar);
-				mvwaddch(gameWindow, y, screenX + 1, ' ');
-			} else {
-				mvwaddstr(gameWindow, y, screenX, "  ");
-			}
-		}
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x <= width; ++x)
+			drawGroundCell(x, y);
 	}
 	wattroff(gameWindow, COLOR_PAIR(5) | A_DIM);
 }
 
+// Arena coordinates; the caller sets the ground colors
+void NCursesGraphic::drawGroundCell(int x, int y) {
+	int screenX = (x * 2) + 4;
+	char groundChar = groundPattern[y][x];
+	if (groundChar != ' ') {
+		mvwaddch(gameWindow, y + 4, screenX, groundChar);
+		mvwaddch(gameWindow, y + 4, screenX + 1, ' ');
+	} else {
+		mvwaddstr(gameWindow, y + 4, screenX, "  ");
+	}
+}
+
+// Repaints one arena cell from scratch: ground, then whatever sits on it now
+void NCursesGraphic::drawCell(const GameState &state, Vec2 cell) {
+	Vec2 head = state.snake.getHead();
+	bool isHead = (cell.x == head.x && cell.y == head.y);
+
+	// Only a head that just ran into the wall lies outside; it's drawn over the border like a full paint does
+	if (state.occupancy.inBounds(cell)) {
+		wattron(gameWindow, COLOR_PAIR(5) | A_DIM);
+		drawGroundCell(cell.x, cell.y);
+		wattroff(gameWindow, COLOR_PAIR(5) | A_DIM);
+	} else if (!isHead)
+		return;
+
+	// Crowded arenas say who holds the cell; otherwise only the player can
+	if (isHead || state.occupancy.isOccupied(cell)) {
+		int owner = isHead ? 0 : std::max(0, state.occupancy.getSnakeAt(cell));
+		int color = COLOR_PAIR(owner == 0 ? 1 : 6);
+		wattron(gameWindow, color);
+		mvwaddstr(gameWindow, cell.y + 4, (cell.x * 2) + 4, snakeGlyph(state.snakes[owner], cell));
+		wattroff(gameWindow, color);
+	}
+
+	int food = state.occupancy.hasOwners() ? state.occupancy.getFoodAt(cell) : 0;
+	Vec2 foodCell = food >= 0 ? state.foods[food].getPosition() : Vec2{ -1, -1 };
+	if (foodCell.x == cell.x && foodCell.y == cell.y)
+		drawFood(state.foods[food]);
+}
+
+// Body glyphs alternate by cell parity, which along a body of adjacent cells is the same as
+// alternating by segment but doesn't flip every segment each time the snake moves
+const char *NCursesGraphic::snakeGlyph(const Snake &snake, Vec2 cell) const {
+	Vec2 head = snake.getHead();
+	Vec2 tail = snake.getTail();
+	if (cell.x == head.x && cell.y == head.y)
+		return "⬢ ";
+	if (cell.x == tail.x && cell.y == tail.y)
+		return "○ ";
+	return ((cell.x + cell.y) & 1) ? "✲ " : "✛ ";
+}
+
 void NCursesGraphic::drawBorder() {
 	int win_height, win_width;
 	getmaxyx(gameWindow, win_height, win_width);
@@ -511,28 +623,18 @@ void NCursesGraphic::drawBorder() {
 	wattroff(gameWindow, COLOR_PAIR(4));
 }
 
-void NCursesGraphic::drawSnake(const GameState &state) {
-	wattron(gameWindow, COLOR_PAIR(1));
-	for (int i = 0; i < state.snake.getLength(); ++i) {
-		int y = state.snake.getSegments()[i].y + 4;
-		int x = (state.snake.getSegments()[i].x * 2) + 4;
-		
-		if (i == 0) {
-			mvwaddstr(gameWindow, y, x, "⬢ ");
-		} else {
-			mvwaddstr(gameWindow, y, x,
-				(i == state.snake.getLength() - 1) ? "○ " :
-				(i % 2 == 0) ? "✛ " : "✲ "
-			);
-		}
-	}
-	wattroff(gameWindow, COLOR_PAIR(1));
+void NCursesGraphic::drawSnake(const Snake &snake) {
+	int color = COLOR_PAIR(snake.getId() == 0 ? 1 : 6);
+	wattron(gameWindow, color);
+	for (const Vec2 &segment : snake)
+		mvwaddstr(gameWindow, segment.y + 4, (segment.x * 2) + 4, snakeGlyph(snake, segment));
+	wattroff(gameWindow, color);
 }
 
-void NCursesGraphic::drawFood(const GameState &state) {
+void NCursesGraphic::drawFood(const Food &food) {
 	wattron(gameWindow, COLOR_PAIR(2));
-	int foodX = (state.food.getPosition().x * 2) + 4;
-	mvwaddstr(gameWindow, state.food.getPosition().y + 4, foodX, state.food.getFoodChar());
+	int foodX = (food.getPosition().x * 2) + 4;
+	mvwaddstr(gameWindow, food.getPosition().y + 4, foodX, food.getFoodChar());
 	wattroff(gameWindow, COLOR_PAIR(2));
 }
 
@@ -0,0 +1,33 @@
+#include "../../incs/NullGraphic.hpp"
+
+NullGraphic::NullGraphic() : width(0), height(0), framesRendered(0) {}
+
+NullGraphic::~NullGraphic() {
+	std::cout << BWHT << "[Null] Destroyed after " << framesRendered << " frames" << RESET << std::endl;
+}
+
+void NullGraphic::init(int w, int h) {
+	width = w;
+	height = h;
+	std::cout << BWHT << "[Null] Initialized: " << width << "x" << height << RESET << std::endl;
+}
+
+void NullGraphic::render(const GameState &state, float deltaTime) {
+	(void)state;
+	(void)deltaTime;
+	framesRendered++;
+}
+
+void NullGraphic::renderMenu(const GameState &state, float deltaTime) {
+	(void)state;
+	(void)deltaTime;
+	framesRendered++;
+}
+
+void NullGraphic::renderGameOver(const GameState &state, float deltaTime) {
+	(void)state;
+	(void)deltaTime;
+	framesRendered++;
+}
+
+Input NullGraphic::pollInput() { return Input::None; }
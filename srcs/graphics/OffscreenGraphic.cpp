@@ -0,0 +1,239 @@
+#include "../../incs/OffscreenGraphic.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+static const int		MAX_FRAME_SIDE = 4096;		// larger arenas get smaller cells
+static const uint64_t	FNV_OFFSET = 14695981039346656037ull;
+static const uint64_t	FNV_PRIME = 1099511628211ull;
+
+// Bytes in memory are R, G, B, A whatever the host's byte order, so dumps and hashes match across machines
+static uint32_t rgba(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) {
+	uint8_t bytes[4] = { r, g, b, a };
+	uint32_t pixel;
+	std::memcpy(&pixel, bytes, sizeof(pixel));
+	return pixel;
+}
+
+// Same palette as SDLGraphic
+static const uint32_t customBlack = rgba(23, 23, 23);
+static const uint32_t customWhite = rgba(255, 248, 227);
+static const uint32_t lightRed = rgba(254, 74, 81);
+static const uint32_t lightBlue = rgba(70, 130, 180);
+static const uint32_t lightPurple = rgba(147, 112, 219);
+
+static uint64_t fnv1a(const void *data, size_t size, uint64_t hash = FNV_OFFSET) {
+	const uint8_t *bytes = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= bytes[i];
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+OffscreenGraphic::OffscreenGraphic() : gridWidth(0), gridHeight(0), cellSize(20), borderOffset(0),
+	frameWidth(0), frameHeight(0), interpolation(1.0f), isInitialized(false), frames(0),
+	busyTime(std::chrono::steady_clock::duration::zero()), dump(nullptr), hashes(nullptr), sessionHash(FNV_OFFSET),
+	buffers(1), stopping(false) {}
+
+OffscreenGraphic::~OffscreenGraphic() {
+	if (!isInitialized)
+		return;
+
+	if (writer.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(queueMutex);
+			stopping = true;
+		}
+		queueChanged.notify_all();
+		writer.join();
+	}
+	if (dump)
+		std::fclose(dump);
+	if (hashes)
+		std::fclose(hashes);
+
+	double seconds = std::chrono::duration<double>(busyTime).count();
+	std::cout << BWHT << "[Offscreen] " << gridWidth << "x" << gridHeight << " arena, " << frameWidth << "x"
+		<< frameHeight << " px: " << frames << " frames, " << (seconds > 0.0 ? frames / seconds : 0.0) << " fps";
+	if (hashes) {
+		char digest[17];
+		std::snprintf(digest, sizeof(digest), "%016" PRIx64, sessionHash);
+		std::cout << ", digest " << digest;
+	}
+	std::cout << RESET << std::endl;
+}
+
+// Allocating (and so faulting in) the framebuffer is the only slow part and needs nothing else
+void OffscreenGraphic::prewarm(int width, int height) {
+	gridWidth = width;
+	gridHeight = height;
+	if (const char *cell = std::getenv("NIBBLER_OFFSCREEN_CELL"))
+		cellSize = std::max(1, std::atoi(cell));
+	cellSize = std::max(1, std::min(cellSize, MAX_FRAME_SIDE / (std::max(width, height) + 2)));
+	borderOffset = cellSize;
+	frameWidth = width * cellSize + 2 * borderOffset;
+	frameHeight = height * cellSize + 2 * borderOffset;
+	pixels.assign(static_cast<size_t>(frameWidth) * frameHeight, customBlack);
+}
+
+void OffscreenGraphic::init(int width, int height) {
+	if (pixels.empty() || gridWidth != width || gridHeight != height)
+		prewarm(width, height);
+
+	const char *dumpPath = std::getenv("NIBBLER_FRAME_DUMP");
+	const char *hashPath = std::getenv("NIBBLER_FRAME_HASH");
+	// A pipe blocks here until something reads from it
+	if (dumpPath && !(dump = std::fopen(dumpPath, "wb")))
+		std::cerr << "Offscreen: can't open " << dumpPath << " for frames: " << std::strerror(errno) << std::endl;
+	if (hashPath && !(hashes = std::fopen(hashPath, "w")))
+		std::cerr << "Offscreen: can't open " << hashPath << " for hashes: " << std::strerror(errno) << std::endl;
+	if (dump || hashes)
+		writer = std::thread(&OffscreenGraphic::writeLoop, this);
+
+	isInitialized = true;
+	std::cout << BWHT << "[Offscreen] Initialized: " << width << "x" << height << " at " << cellSize << " px per cell"
+		<< (dump ? ", dumping frames" : "") << (hashes ? ", hashing frames" : "") << RESET << std::endl;
+}
+
+void OffscreenGraphic::fillRect(int x, int y, int w, int h, uint32_t color) {
+	int left = std::max(x, 0);
+	int top = std::max(y, 0);
+	int right = std::min(x + w, frameWidth);
+	int bottom = std::min(y + h, frameHeight);
+	if (left >= right)
+		return;
+	for (int row = top; row < bottom; ++row)
+		std::fill_n(pixels.data() + static_cast<size_t>(row) * frameWidth + left, right - left, color);
+}
+
+void OffscreenGraphic::drawScene(const GameState &state) {
+	std::fill(pixels.begin(), pixels.end(), customBlack);
+	for (const Snake &snake : state.snakes) {
+		if (snake.isAlive())
+			drawSnake(snake);
+	}
+	for (const Food &food : state.foods)
+		drawFood(food);
+	drawBorder(cellSize);
+}
+
+// Same geometry as SDLGraphic::drawSnake(), head and tail slid by the interpolation alpha
+void OffscreenGraphic::drawSnake(const Snake &snake) {
+	int last = snake.getLength() - 1;
+	float headX = snake.getPreviousHead().x + (snake.getHead().x - snake.getPreviousHead().x) * interpolation;
+	float headY = snake.getPreviousHead().y + (snake.getHead().y - snake.getPreviousHead().y) * interpolation;
+	float tailX = snake.getPreviousTail().x + (snake.getTail().x - snake.getPreviousTail().x) * interpolation;
+	float tailY = snake.getPreviousTail().y + (snake.getTail().y - snake.getPreviousTail().y) * interpolation;
+
+	uint32_t color = snake.getId() == 0 ? lightBlue : lightPurple;
+	int index = 0;
+	for (const Vec2 &segment : snake) {
+		float x = segment.x;
+		float y = segment.y;
+		if (index == 0) {
+			x = headX;
+			y = headY;
+		} else if (index == last) {
+			x = tailX;
+			y = tailY;
+		}
+		fillRect(borderOffset + static_cast<int>(x * cellSize), borderOffset + static_cast<int>(y * cellSize),
+			cellSize, cellSize, color);
+		++index;
+	}
+}
+
+void OffscreenGraphic::drawFood(const Food &food) {
+	fillRect(borderOffset + food.getPosition().x * cellSize, borderOffset + food.getPosition().y * cellSize,
+		cellSize, cellSize, lightRed);
+}
+
+void OffscreenGraphic::drawBorder(int thickness) {
+	int innerW = gridWidth * cellSize;
+	int innerH = gridHeight * cellSize;
+	fillRect(borderOffset - thickness, borderOffset - thickness, innerW + 2 * thickness, thickness, customWhite);
+	fillRect(borderOffset - thickness, borderOffset + innerH, innerW + 2 * thickness, thickness, customWhite);
+	fillRect(borderOffset - thickness, borderOffset, thickness, innerH, customWhite);
+	fillRect(borderOffset + innerW, borderOffset, thickness, innerH, customWhite);
+}
+
+void OffscreenGraphic::render(const GameState &state, float deltaTime) {
+	(void)deltaTime;
+	frameStart = std::chrono::steady_clock::now();
+	drawScene(state);
+}
+
+// SDL's menu is mostly text; without fonts only the empty arena is left
+void OffscreenGraphic::renderMenu(const GameState &state, float deltaTime) {
+	(void)state;
+	(void)deltaTime;
+	frameStart = std::chrono::steady_clock::now();
+	std::fill(pixels.begin(), pixels.end(), customBlack);
+	drawBorder(cellSize);
+}
+
+void OffscreenGraphic::renderGameOver(const GameState &state, float deltaTime) {
+	(void)deltaTime;
+	frameStart = std::chrono::steady_clock::now();
+	drawScene(state);
+}
+
+// The finished frame swaps places with a spare buffer, so the writer gets it without a copy.
+// Waiting for the writer is left out of busyTime: the fps are the renderer's, whatever dumping costs
+void OffscreenGraphic::present() {
+	if (writer.joinable()) {
+		std::unique_lock<std::mutex> lock(queueMutex);
+		busyTime += std::chrono::steady_clock::now() - frameStart;
+		queueChanged.wait(lock, [this] { return !spare.empty() || buffers <= MAX_QUEUED; });
+		frameStart = std::chrono::steady_clock::now();
+		std::vector<uint32_t> next;
+		if (spare.empty()) {
+			next.resize(pixels.size());
+			buffers++;
+		} else {
+			next = std::move(spare.back());
+			spare.pop_back();
+		}
+		queued.push_back(std::move(pixels));
+		pixels = std::move(next);
+		queueChanged.notify_all();
+	}
+	frames++;
+	busyTime += std::chrono::steady_clock::now() - frameStart;
+}
+
+// Drains whatever is queued before it stops, so the dump always holds every presented frame
+void OffscreenGraphic::writeLoop() {
+	std::unique_lock<std::mutex> lock(queueMutex);
+	while (true) {
+		queueChanged.wait(lock, [this] { return stopping || !queued.empty(); });
+		if (queued.empty())
+			return;
+		std::vector<uint32_t> frame = std::move(queued.front());
+		queued.pop_front();
+		lock.unlock();
+
+		if (dump)
+			std::fwrite(frame.data(), sizeof(uint32_t), frame.size(), dump);
+		if (hashes) {
+			uint64_t hash = fnv1a(frame.data(), frame.size() * sizeof(uint32_t));
+			std::fprintf(hashes, "%016" PRIx64 "\n", hash);
+			// Little-endian whatever the host, like the frames themselves
+			uint8_t bytes[sizeof(hash)];
+			for (size_t i = 0; i < sizeof(hash); ++i)
+				bytes[i] = static_cast<uint8_t>(hash >> (8 * i));
+			sessionHash = fnv1a(bytes, sizeof(bytes), sessionHash);
+		}
+
+		lock.lock();
+		spare.push_back(std::move(frame));
+		queueChanged.notify_all();
+	}
+}
+
+void OffscreenGraphic::setInterpolation(float alpha) { interpolation = alpha; }
+
+Input OffscreenGraphic::pollInput() { return Input::None; }
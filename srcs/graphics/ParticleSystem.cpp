@@ -1,23 +1,23 @@
 #include "../../incs/ParticleSystem.hpp"
 
 // Particle constructors
-Particle::Particle(float px, float py, float minSize, float maxSize, float minLifetime, float maxLifetime)
+Particle::Particle(float px, float py, float minSize, float maxSize, float minLifetime, float maxLifetime, Rng &rng)
 	: x(px), y(py), vx(0), vy(0), age(0.0f), type(ParticleType::Dust), color({ 255, 248, 227, 255}) {
-	initialSize = minSize + static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * (maxSize - minSize);
+	initialSize = minSize + rng.getFloat() * (maxSize - minSize);
 	currentSize = initialSize;
-	lifetime = minLifetime + static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * (maxLifetime - minLifetime);
-	rotation = static_cast<float>(rand() % 360);
-	rotationSpeed = -30.0f + static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * 60.0f;  // -30 to +30 deg/s
+	lifetime = minLifetime + rng.getFloat() * (maxLifetime - minLifetime);
+	rotation = static_cast<float>(rng.getInt(359));
+	rotationSpeed = -30.0f + rng.getFloat() * 60.0f;  // -30 to +30 deg/s
 }
 
 Particle::Particle(float px, float py, float minSize, float maxSize, float minLifetime, float maxLifetime, 
-		float velocityX, float velocityY, SDL_Color particleColor)
+		float velocityX, float velocityY, SDL_Color particleColor, Rng &rng)
 	: x(px), y(py), vx(velocityX), vy(velocityY), age(0.0f), type(ParticleType::Explosion), color(particleColor) {
-	initialSize = minSize + static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * (maxSize - minSize);
+	initialSize = minSize + rng.getFloat() * (maxSize - minSize);
 	currentSize = initialSize;
-	lifetime = minLifetime + static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * (maxLifetime - minLifetime);
-	rotation = static_cast<float>(rand() % 360);
-	rotationSpeed = -50.0f + static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * 100.0f;  // -50 to +50 deg/s for explosions
+	lifetime = minLifetime + rng.getFloat() * (maxLifetime - minLifetime);
+	rotation = static_cast<float>(rng.getInt(359));
+	rotationSpeed = -50.0f + rng.getFloat() * 100.0f;  // -50 to +50 deg/s for explosions
 }
 
 // ParticleSystem implementation
@@ -95,23 +95,23 @@ void ParticleSystem::spawnDustParticle() {
 	int arenaW = gridWidth * cellSize;
 	int arenaH = gridHeight * cellSize;
 	
-	float x = arenaX + static_cast<float>(rand() % arenaW);
-	float y = arenaY + static_cast<float>(rand() % arenaH);
+	float x = arenaX + static_cast<float>(rng.getInt(arenaW - 1));
+	float y = arenaY + static_cast<float>(rng.getInt(arenaH - 1));
 	
-	particles.emplace_back(x, y, dustMinSize, dustMaxSize, dustMinLifetime, dustMaxLifetime);
+	particles.emplace_back(x, y, dustMinSize, dustMaxSize, dustMinLifetime, dustMaxLifetime, rng);
 }
 
 void ParticleSystem::spawnExplosion(float x, float y, int count) {
 	for (int i = 0; i < count; i++) {
 
-		float angle = (rand() % 360) * 3.14159f / 180.0f;
-		float speed = 50.0f + (rand() % 150);	// 50-200 pixels/sec
+		float angle = rng.getInt(359) * 3.14159f / 180.0f;
+		float speed = 50.0f + rng.getInt(149);	// 50-200 pixels/sec
 		float vx = cosf(angle) * speed;
 		float vy = sinf(angle) * speed;
 		
 		SDL_Color explosionColor = {254, 74, 81, 255};	// lightRed
 		
-		particles.emplace_back(x, y, explosionMinSize, explosionMaxSize, 0.5f, 1.0f, vx, vy, explosionColor);
+		particles.emplace_back(x, y, explosionMinSize, explosionMaxSize, 0.5f, 1.0f, vx, vy, explosionColor, rng);
 	}
 }
 
@@ -122,16 +122,16 @@ void ParticleSystem::spawnDirectedParticles(float x, float y, int count, float d
 	
 	for (int i = 0; i < count; i++) {
 		// Random angle within spread cone
-		float angleOffset = (static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5f) * spreadRad;
+		float angleOffset = (rng.getFloat() - 0.5f) * spreadRad;
 		float angle = baseAngle + angleOffset;
 		
-		float speed = minSpeed + (static_cast<float>(rand()) / static_cast<float>(RAND_MAX)) * (maxSpeed - minSpeed);
+		float speed = minSpeed + rng.getFloat() * (maxSpeed - minSpeed);
 		float vx = cosf(angle) * speed;
 		float vy = sinf(angle) * speed;
 		
 		SDL_Color color = {70, 130, 180, 255};	// lightBlue
 		
-		particles.emplace_back(x, y, 5.0f, 15.0f, 1.0f, 2.0f, vx, vy, color);
+		particles.emplace_back(x, y, 5.0f, 15.0f, 1.0f, 2.0f, vx, vy, color, rng);
 	}
 }
 
@@ -143,19 +143,19 @@ void ParticleSystem::spawnDirectedParticlesInArea(float centerX, float centerY,
 	
 	for (int i = 0; i < count; i++) {
 		// Random spawn position within area
-		float spawnX = centerX + (static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5f) * areaWidth;
-		float spawnY = centerY + (static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5f) * areaHeight;
+		float spawnX = centerX + (rng.getFloat() - 0.5f) * areaWidth;
+		float spawnY = centerY + (rng.getFloat() - 0.5f) * areaHeight;
 		
 		// Random angle within spread cone
-		float angleOffset = (static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5f) * spreadRad;
+		float angleOffset = (rng.getFloat() - 0.5f) * spreadRad;
 		float angle = baseAngle + angleOffset;
 		
 		// Random speed
-		float speed = minSpeed + (static_cast<float>(rand()) / static_cast<float>(RAND_MAX)) * (maxSpeed - minSpeed);
+		float speed = minSpeed + rng.getFloat() * (maxSpeed - minSpeed);
 		float vx = cosf(angle) * speed;
 		float vy = sinf(angle) * speed;
 		
-		particles.emplace_back(spawnX, spawnY, 5.0f, 15.0f, 1.0f, 2.0f, vx, vy, color);
+		particles.emplace_back(spawnX, spawnY, 5.0f, 15.0f, 1.0f, 2.0f, vx, vy, color, rng);
 	}
 }
 
@@ -163,21 +163,21 @@ void ParticleSystem::spawnSnakeTrail(float x, float y, int count, float directio
 	float angle = direction * 3.14159f / 180.0f;
 	
 	for (int i = 0; i < count; i++) {
-		float offsetX = (static_cast<float>(rand()) / static_cast<float>(RAND_MAX)) * 30.0f;
-		float offsetY = (static_cast<float>(rand()) / static_cast<float>(RAND_MAX)) * 30.0f;
+		float offsetX = rng.getFloat() * 30.0f;
+		float offsetY = rng.getFloat() * 30.0f;
 		float spawnX = x + offsetX;
 		float spawnY = y + offsetY;
 		
-		float speed = 30.0f + (static_cast<float>(rand()) / static_cast<float>(RAND_MAX)) * 9.0f;
+		float speed = 30.0f + rng.getFloat() * 9.0f;
 		float vx = cosf(angle) * speed;
 		float vy = sinf(angle) * speed;
 		
 		float minSize = (x <= 1135.0f) ? 10.0f : 20.0f;
 		float maxSize = (x <= 1135.0f) ? 15.0f : 25.0f;
-		float lifetime = 0.2f + (static_cast<float>(rand()) / static_cast<float>(RAND_MAX)) * 1.5f;
+		float lifetime = 0.2f + rng.getFloat() * 1.5f;
 		
 		// here particles have no rotation because I want a straight trail
-		Particle particle(spawnX, spawnY, minSize, maxSize, lifetime, lifetime, vx, vy, color);
+		Particle particle(spawnX, spawnY, minSize, maxSize, lifetime, lifetime, vx, vy, color, rng);
 		particle.rotation = 0.0f;
 		particle.rotationSpeed = 0.0f;
 		particle.type = ParticleType::Trail;
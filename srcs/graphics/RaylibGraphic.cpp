@@ -4,6 +4,7 @@
 #include "../../incs/colors.h"
 #include "../../incs/RaylibGraphic.hpp"
 #include <rlgl.h>  // For low-level drawing functions (rlPushMatrix, rlBegin, etc.)
+#include <random>
 
 RaylibGraphic::RaylibGraphic() :
 	cubeSize(2.0f),
@@ -11,9 +12,18 @@ RaylibGraphic::RaylibGraphic() :
 	gridHeight(0),
 	screenWidth(1920),
 	screenHeight(1080),
-	accumulatedTime(0.0f) {}
+	accumulatedTime(0.0f),
+	interpolation(1.0f),
+	grainTexture(),
+	grainImage(),
+	isPrewarmed(false) {}
 
 RaylibGraphic::~RaylibGraphic() {
+		if (grainImage.data)
+			UnloadImage(grainImage);
+		// A plugin that was only pre-warmed never opened a window
+		if (!IsWindowReady())
+			return;
 		UnloadTexture(grainTexture);
 		CloseWindow();
 		std::cout << BYEL << "[Raylib 3D] Destroyed" << RESET << std::endl;
@@ -152,14 +162,24 @@ void RaylibGraphic::drawWalls() {
 void RaylibGraphic::drawSnake(const Snake* snake) {
 	float yPos = cubeSize;
 	
-	for (int i = 0; i < snake->getLength(); i++) {
-		const Vec2& segment = snake->getSegments()[i];
+	int last = snake->getLength() - 1;
+	bool isBot = snake->getId() != 0;
+	
+	int i = 0;
+	for (const Vec2& segment : *snake) {
 		
 		Vector3 position = {
 			segment.x * cubeSize,
 			yPos,
 			segment.y * cubeSize
 		};
+
+		// Head and tail glide between cells, the rest of the body stays on the grid
+		if (i == 0 || i == last) {
+			const Vec2 &from = (i == 0) ? snake->getPreviousHead() : snake->getPreviousTail();
+			position.x = Lerp(from.x, segment.x, interpolation) * cubeSize;
+			position.z = Lerp(from.y, segment.y, interpolation) * cubeSize;
+		}
 		
 		// Head is full size, body is 80% size
 		float size = (i == 0) ? cubeSize : cubeSize * 0.8f;
@@ -168,11 +188,14 @@ void RaylibGraphic::drawSnake(const Snake* snake) {
 		// Checkerboard pattern for all segments
 		if (i % 2 == 0) {
 			drawCubeCustomFaces(position, size, size, size,
-			                    snakeLightFront, snakeHidden, snakeLightTop, snakeHidden, snakeLightSide, snakeHidden);
+			                    isBot ? botLightFront : snakeLightFront, snakeHidden, isBot ? botLightTop : snakeLightTop,
+			                    snakeHidden, isBot ? botLightSide : snakeLightSide, snakeHidden);
 		} else {
 			drawCubeCustomFaces(position, size, size, size,
-			                    snakeDarkFront, snakeHidden, snakeDarkTop, snakeHidden, snakeDarkSide, snakeHidden);
+			                    isBot ? botDarkFront : snakeDarkFront, snakeHidden, isBot ? botDarkTop : snakeDarkTop,
+			                    snakeHidden, isBot ? botDarkSide : snakeDarkSide, snakeHidden);
 		}
+		++i;
 	}
 }
 
@@ -205,20 +228,36 @@ void RaylibGraphic::init(int width, int height) {
 	gridHeight = height;
 	
 	InitWindow(screenWidth, screenHeight, "Nibbler 3D - Raylib");
-	SetTargetFPS(60);
+	SetTargetFPS(0);	// FrameScheduler paces frames; a cap here would override --fps
 	
 	setupCamera();
 	
 	// Grain Texture
-	int paddedWidth = screenWidth + 40;   // +40 pixels (±20 for oscillation)
-	int paddedHeight = screenHeight + 40;
-	Image grainImage = GenImageWhiteNoise(paddedWidth, paddedHeight, 0.75f);
+	if (!isPrewarmed)
+		prewarm(width, height);
 	grainTexture = LoadTextureFromImage(grainImage);
 	UnloadImage(grainImage);
+	grainImage = Image();
 	
 	std::cout << BYEL << "[Raylib 3D] Initialized: " << width << "x" << height << RESET << std::endl;
 }
 
+// The grain noise is generated on the CPU; only the upload to a texture needs the GL context.
+// Same pixels as GenImageWhiteNoise(), but drawn from a local generator rather than raylib's global one
+void RaylibGraphic::prewarm(int width, int height) {
+	(void)width;
+	(void)height;
+	int paddedWidth = screenWidth + 40;   // +40 pixels (±20 for oscillation)
+	int paddedHeight = screenHeight + 40;
+	std::mt19937 gen(std::random_device{}());
+	std::bernoulli_distribution white(0.75);
+	Color *pixels = static_cast<Color*>(MemAlloc(paddedWidth * paddedHeight * sizeof(Color)));
+	for (int i = 0; i < paddedWidth * paddedHeight; ++i)
+		pixels[i] = white(gen) ? WHITE : BLACK;
+	grainImage = (Image){ pixels, paddedWidth, paddedHeight, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+	isPrewarmed = true;
+}
+
 void RaylibGraphic::render(const GameState& state, float deltaTime){
 	if (!state.isPaused) {
         accumulatedTime += deltaTime;
@@ -231,8 +270,12 @@ void RaylibGraphic::render(const GameState& state, float deltaTime){
 	
 	drawGroundPlane();
 	//drawWalls();
-	drawSnake(&state.snake);
-	drawFood(&state.food);
+	for (const Snake &snake : state.snakes) {
+		if (snake.isAlive())
+			drawSnake(&snake);
+	}
+	for (const Food &food : state.foods)
+		drawFood(&food);
 	
 	// Optional: Draw grid lines for debugging
 	// DrawGrid(gridWidth, cubeSize);
@@ -250,8 +293,6 @@ void RaylibGraphic::render(const GameState& state, float deltaTime){
 	
 	// Post Processing
 	drawNoiseGrain();
-	
-	EndDrawing();
 }
 
 void RaylibGraphic::renderMenu(const GameState& state, float deltaTime) {
@@ -264,8 +305,6 @@ void RaylibGraphic::renderMenu(const GameState& state, float deltaTime) {
 	// TODO: Implement proper Raylib menu screen
 	DrawText("NIBBLER", screenWidth/2 - 150, screenHeight/2 - 100, 60, customWhite);
 	DrawText("Press ENTER to start", screenWidth/2 - 150, screenHeight/2, 30, customWhite);
-	
-	EndDrawing();
 }
 
 void RaylibGraphic::renderGameOver(const GameState& state, float deltaTime) {
@@ -281,10 +320,30 @@ void RaylibGraphic::renderGameOver(const GameState& state, float deltaTime) {
 	snprintf(scoreText, sizeof(scoreText), "Score: %d", state.score);
 	DrawText(scoreText, screenWidth/2 - 80, screenHeight/2 + 20, 30, customWhite);
 	DrawText("Press ENTER to restart", screenWidth/2 - 150, screenHeight/2 + 80, 25, customWhite);
-	
+}
+
+void RaylibGraphic::setInterpolation(float alpha) {
+	interpolation = alpha;
+}
+
+// EndDrawing() also swaps buffers and polls window events, so it has to run every frame
+void RaylibGraphic::present() {
 	EndDrawing();
 }
 
+void RaylibGraphic::suspend() {
+	SetWindowState(FLAG_WINDOW_HIDDEN);
+}
+
+// Keys hit while hidden are still waiting in the window's event queue. The first poll takes them in,
+// the second makes them the previous state, so IsKeyPressed() no longer reports them
+void RaylibGraphic::resume() {
+	ClearWindowState(FLAG_WINDOW_HIDDEN);
+	PollInputEvents();
+	PollInputEvents();
+	while (GetKeyPressed() != 0) {}
+}
+
 Input RaylibGraphic::pollInput() {
 	if (IsKeyPressed(KEY_UP))		return Input::Up;
 	if (IsKeyPressed(KEY_DOWN))		return Input::Down;
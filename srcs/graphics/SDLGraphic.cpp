@@ -3,12 +3,14 @@
 
 SDLGraphic::SDLGraphic() : window(nullptr), renderer(nullptr), cellSize(50), borderOffset(0),
 	spawnInterval(0.3f), animationSpeed(.5f), enableTunnelEffect(true),
-	lastFoodX(-1), lastFoodY(-1),
-	lastTailX(-1.0f), lastTailY(-1.0f), isFirstFrame(true) {
+	lastTailX(-1.0f), lastTailY(-1.0f), isFirstFrame(true), interpolation(1.0f), isPrewarmed(false) {
 	lastSpawnTime = std::chrono::high_resolution_clock::now();
 }
 
 SDLGraphic::~SDLGraphic() {
+	// A plugin that was only pre-warmed never started SDL
+	if (!window)
+		return;
 	textRenderer.reset();
 	TTF_Quit();
 	if (renderer) SDL_DestroyRenderer(renderer);
@@ -57,8 +59,10 @@ void SDLGraphic::init(int width, int height) {
 	}
 	
 	// Initialize text renderer
+	if (!isPrewarmed)
+		prewarm(width, height);
 	textRenderer = std::make_unique<TextRenderer>(renderer);
-	if (!textRenderer->init(windowWidth)) {
+	if (!textRenderer->init(windowWidth, fontData)) {
 		std::cerr << "TextRenderer initialization failed" << std::endl;
 	}
 	
@@ -73,6 +77,14 @@ void SDLGraphic::init(int width, int height) {
 	std::cout << BRED << "[SDL2] Initialized: " << width << "x" << height << RESET << std::endl;
 }
 
+// Only the font file is read here; SDL itself can't be touched off the main thread
+void SDLGraphic::prewarm(int width, int height) {
+	(void)width;
+	(void)height;
+	fontData = TextRenderer::readFontFile();
+	isPrewarmed = true;
+}
+
 void SDLGraphic::setRenderColor(SDL_Color color, bool customAlpha, Uint8 alphaValue) {
 	if (customAlpha) {
 		SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, alphaValue);
@@ -93,73 +105,100 @@ void SDLGraphic::render(const GameState& state, float deltaTime) {
 	renderTunnelEffect();
 	particleSystem->render();
 	
-	drawSnake(state);
-	drawFood(state);
+	for (const Snake &snake : state.snakes) {
+		if (snake.isAlive())
+			drawSnake(snake);
+	}
+	lastFoods.resize(state.foods.size(), Vec2{ -1, -1 });
+	for (size_t i = 0; i < state.foods.size(); ++i)
+		drawFood(state.foods[i], lastFoods[i]);
 
 	drawBorder(cellSize);
-	
-	SDL_RenderPresent(renderer);
 }
 
-void SDLGraphic::drawSnake(const GameState &state) {
-	setRenderColor(lightBlue);
-	for (int i = 0; i < state.snake.getLength(); ++i) {
+void SDLGraphic::setInterpolation(float alpha) {
+	interpolation = alpha;
+}
+
+void SDLGraphic::drawSnake(const Snake &snake) {
+	int last = snake.getLength() - 1;
+
+	// Head and tail slide over from where they were on the previous tick, the body in between stays on the grid
+	float headX = snake.getPreviousHead().x + (snake.getHead().x - snake.getPreviousHead().x) * interpolation;
+	float headY = snake.getPreviousHead().y + (snake.getHead().y - snake.getPreviousHead().y) * interpolation;
+	float tailCellX = snake.getPreviousTail().x + (snake.getTail().x - snake.getPreviousTail().x) * interpolation;
+	float tailCellY = snake.getPreviousTail().y + (snake.getTail().y - snake.getPreviousTail().y) * interpolation;
+
+	setRenderColor(snake.getId() == 0 ? lightBlue : lightPurple);
+	int index = 0;
+	for (const Vec2 &segment : snake) {
+		float x = segment.x;
+		float y = segment.y;
+		if (index == 0) {
+			x = headX;
+			y = headY;
+		} else if (index == last) {
+			x = tailCellX;
+			y = tailCellY;
+		}
 		SDL_Rect rect = {
-			borderOffset + (state.snake.getSegments()[i].x * cellSize),
-			borderOffset + (state.snake.getSegments()[i].y * cellSize),
+			borderOffset + static_cast<int>(x * cellSize),
+			borderOffset + static_cast<int>(y * cellSize),
 			cellSize,
 			cellSize
 		};
 		SDL_RenderFillRect(renderer, &rect);
+		++index;
+	}
 		
-		if (i == state.snake.getLength() - 1 && state.snake.getLength() > 1) {
-			float tailX = borderOffset + (state.snake.getSegments()[i].x * cellSize) + (cellSize / 2.0f);
-			float tailY = borderOffset + (state.snake.getSegments()[i].y * cellSize) + (cellSize / 2.0f);
-			
-			Vec2 tail = state.snake.getSegments()[i];
-			Vec2 beforeTail = state.snake.getSegments()[i - 1];
-			float direction = 0.0f;
+	// The trail follows the player only
+	if (snake.getId() == 0 && snake.getLength() > 1) {
+		Vec2 tail = snake.getTail();
+		Vec2 beforeTail = snake.getSegment(last - 1);
+
+		float tailX = borderOffset + (tailCellX * cellSize) + (cellSize / 2.0f);
+		float tailY = borderOffset + (tailCellY * cellSize) + (cellSize / 2.0f);
+		
+		float direction = 0.0f;
+		
+		if (tail.x > beforeTail.x) direction = 0.0f;		// Moving right
+		else if (tail.x < beforeTail.x) direction = 180.0f;	// Moving left
+		else if (tail.y > beforeTail.y) direction = 90.0f;  // Moving down
+		else if (tail.y < beforeTail.y) direction = 270.0f; // Moving up
+		
+		if (!isFirstFrame && (lastTailX != tailX || lastTailY != tailY)) {
+			float dx = tailX - lastTailX;
+			float dy = tailY - lastTailY;
+			float distance = sqrtf(dx * dx + dy * dy);
 			
-			if (tail.x > beforeTail.x) direction = 0.0f;		// Moving right
-			else if (tail.x < beforeTail.x) direction = 180.0f;	// Moving left
-			else if (tail.y > beforeTail.y) direction = 90.0f;  // Moving down
-			else if (tail.y < beforeTail.y) direction = 270.0f; // Moving up
+			int steps = static_cast<int>(distance / 15.0f) + 1;
 			
-			if (!isFirstFrame && (lastTailX != tailX || lastTailY != tailY)) {
-				float dx = tailX - lastTailX;
-				float dy = tailY - lastTailY;
-				float distance = sqrtf(dx * dx + dy * dy);
-				
-				int steps = static_cast<int>(distance / 15.0f) + 1;
+			for (int step = 0; step < steps; ++step) {
+				float t = static_cast<float>(step) / static_cast<float>(steps);
+				float interpX = lastTailX + (dx * t);
+				float interpY = lastTailY + (dy * t);
 				
-				for (int step = 0; step < steps; ++step) {
-					float t = static_cast<float>(step) / static_cast<float>(steps);
-					float interpX = lastTailX + (dx * t);
-					float interpY = lastTailY + (dy * t);
-					
-					particleSystem->spawnSnakeTrail(interpX - 10.0f, interpY - 10.0f, 1, direction, lightBlue);
-				}
+				particleSystem->spawnSnakeTrail(interpX - 10.0f, interpY - 10.0f, 1, direction, lightBlue);
 			}
-			
-			lastTailX = tailX;
-			lastTailY = tailY;
-			isFirstFrame = false;
 		}
+		
+		lastTailX = tailX;
+		lastTailY = tailY;
+		isFirstFrame = false;
 	}
 }
 
-void SDLGraphic::drawFood(const GameState &state) {
-	int currentFoodX = state.food.getPosition().x;
-	int currentFoodY = state.food.getPosition().y;
+void SDLGraphic::drawFood(const Food &food, Vec2 &lastFood) {
+	int currentFoodX = food.getPosition().x;
+	int currentFoodY = food.getPosition().y;
 	
-	if (lastFoodX != -1 && (lastFoodX != currentFoodX || lastFoodY != currentFoodY)) {
-		float explosionX = borderOffset + (lastFoodX * cellSize) + (cellSize / 2.0f);
-		float explosionY = borderOffset + (lastFoodY * cellSize) + (cellSize / 2.0f);
+	if (lastFood.x != -1 && (lastFood.x != currentFoodX || lastFood.y != currentFoodY)) {
+		float explosionX = borderOffset + (lastFood.x * cellSize) + (cellSize / 2.0f);
+		float explosionY = borderOffset + (lastFood.y * cellSize) + (cellSize / 2.0f);
 		particleSystem->spawnExplosion(explosionX, explosionY, 20);  // 20 particles per explosion
 	}
 	
-	lastFoodX = currentFoodX;
-	lastFoodY = currentFoodY;
+	lastFood = food.getPosition();
 	
 	setRenderColor(lightRed);
 	SDL_Rect foodRect = {
@@ -192,6 +231,29 @@ void SDLGraphic::drawBorder(int thickness) {
 	SDL_RenderFillRect(renderer, &right);
 }
 	
+void SDLGraphic::present() {
+	SDL_RenderPresent(renderer);
+}
+
+void SDLGraphic::suspend() {
+	SDL_HideWindow(window);
+}
+
+// Events queued while hidden belonged to another backend; trail and explosion tracking starts over
+// so nothing streaks from where things were before the switch
+void SDLGraphic::resume() {
+	SDL_ShowWindow(window);
+	SDL_RaiseWindow(window);
+	SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+	isFirstFrame = true;
+	lastFoods.clear();
+}
+
+// A null event leaves whatever arrived in the queue for pollInput()
+int SDLGraphic::waitEvents(int timeoutMs) {
+	return SDL_WaitEventTimeout(nullptr, timeoutMs) ? 1 : 0;
+}
+
 Input SDLGraphic::pollInput() {
 	SDL_Event event;
 	while (SDL_PollEvent(&event)) {
@@ -322,8 +384,7 @@ void SDLGraphic::renderMenu(const GameState& state, float deltaTime) {
 	windowWidth = (gridWidth * cellSize) + (2 * borderOffset);
 	windowHeight = (gridHeight * cellSize) + (2 * borderOffset);
 
-	lastFoodX = -1;
-	lastFoodY = -1;
+	lastFoods.clear();
 
 	static int frameCounter = 0;
 	if (frameCounter % 111 == 0) {
@@ -349,8 +410,6 @@ void SDLGraphic::renderMenu(const GameState& state, float deltaTime) {
 
 	titleHandler->renderTitle(centerX, centerY, square, sep, customWhite, lightBlue, lightRed);
 	drawInstructions(centerX, centerY);
-	
-	SDL_RenderPresent(renderer);
 }
 
 void SDLGraphic::drawRetryText(const GameState &state, int centerX, int centerY) {
@@ -389,6 +448,4 @@ void SDLGraphic::renderGameOver(const GameState& state, float deltaTime) {
 	
 	titleHandler->renderGameOver(centerX, centerY, square, sep, customWhite);
 	drawRetryText(state, centerX, centerY);
-	
-	SDL_RenderPresent(renderer);
 }
\ No newline at end of file
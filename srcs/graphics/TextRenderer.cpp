@@ -15,31 +15,50 @@ TextRenderer::~TextRenderer() {
 	}
 }
 
-bool TextRenderer::init(int windowWidth) {
+static const char *const FONT_PATHS[] = {
+	"fonts/JetBrainsMono-VariableFont_wght.ttf",
+	"/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf"	// Fallback to system font
+};
+
+std::vector<char> TextRenderer::readFontFile() {
+	for (const char *path : FONT_PATHS) {
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file.is_open())
+			continue;
+		std::vector<char> data(file.tellg());
+		file.seekg(0);
+		if (file.read(data.data(), data.size()))
+			return data;
+	}
+	return {};
+}
+
+static TTF_Font *openFont(const std::vector<char> &fontData, int size) {
+	if (!fontData.empty())
+		return TTF_OpenFontRW(SDL_RWFromConstMem(fontData.data(), static_cast<int>(fontData.size())), 1, size);
+	TTF_Font *font = TTF_OpenFont(FONT_PATHS[0], size);
+	if (!font)
+		font = TTF_OpenFont(FONT_PATHS[1], size);
+	return font;
+}
+
+bool TextRenderer::init(int windowWidth, const std::vector<char> &fontData) {
 	int mainSize = (windowWidth < 1800) ? 34 : 34;
 	int smallSize = (windowWidth < 1800) ? 24 : 24;
 
 	// Load main font
-	mainFont = TTF_OpenFont("fonts/JetBrainsMono-VariableFont_wght.ttf", mainSize);
+	mainFont = openFont(fontData, mainSize);
 	if (!mainFont) {
-		// Fallback to system font
-		mainFont = TTF_OpenFont("/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf", mainSize);
-		if (!mainFont) {
-			std::cerr << "Main font loading error: " << TTF_GetError() << std::endl;
-			return false;
-		}
+		std::cerr << "Main font loading error: " << TTF_GetError() << std::endl;
+		return false;
 	}
 
 	// Load small font
-	smallFont = TTF_OpenFont("fonts/JetBrainsMono-VariableFont_wght.ttf", smallSize);
+	smallFont = openFont(fontData, smallSize);
 	if (!smallFont) {
-		// Fallback to system font
-		smallFont = TTF_OpenFont("/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf", smallSize);
-		if (!smallFont) {
-			std::cerr << "Small font loading error: " << TTF_GetError() << std::endl;
-			// Use main font as fallback for small font
-			smallFont = mainFont;
-		}
+		std::cerr << "Small font loading error: " << TTF_GetError() << std::endl;
+		// Use main font as fallback for small font
+		smallFont = mainFont;
 	}
 
 	initialized = (mainFont != nullptr);
@@ -0,0 +1,382 @@
+#include "../incs/IGraphic.hpp"
+#include "../incs/Snake.hpp"
+#include "../incs/Food.hpp"
+#include "../incs/OccupancyGrid.hpp"
+#include "../incs/DataStructs.hpp"
+#include "../incs/GameManager.hpp"
+#include "../incs/LibraryManager.hpp"
+#include "../incs/BatchEngine.hpp"
+#include "../incs/Bot.hpp"
+#include "../incs/Rng.hpp"
+#include "../incs/Replay.hpp"
+#include "../incs/Tracer.hpp"
+#include "../incs/colors.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+Headless driver: runs GameManager::update() back to back, no frame pacing and no sleeping.
+Input comes either from a script file ("<tick> <up|down|left|right>" per line, ticks counted
+across the whole run) or from a wandering bot that mostly heads for the food, turns at random otherwise, and avoids walls
+and its own body.
+Dead games are restarted on the spot, so a run always lasts the requested number of ticks.
+With --batch N the bot plays N arenas at once through BatchEngine, spread over --threads workers.
+A run is fully reproducible from --seed: game n plays with seed + n (game g of batch arena i with seed + i + g * N)
+and the bot draws from its own generator.
+--record saves the single-game run as a replay; --replay plays one back as fast as possible and checks every game
+ends on the recorded tick with the recorded score.
+--snakes N and --food N make it a crowded arena: the bot still drives snake 0, the others steer themselves.
+*/
+
+struct ScriptedInput {
+	long	tick;
+	Input	input;
+};
+
+static void printUsage() {
+	std::cerr << BYEL << "Usage: ./nibbler_headless <width> <height> [--ticks N] [--seed N] [--script file] [--lib path.so] [--record file] [--trace file] [--snakes N] [--food N] [--batch N [--threads N]]" << RESET << std::endl;
+	std::cerr << BYEL << "       ./nibbler_headless --replay file" << RESET << std::endl;
+}
+
+static bool parseDirection(const std::string &word, Input &input) {
+	if (word == "up" || word == "U")			input = Input::Up;
+	else if (word == "down" || word == "D")		input = Input::Down;
+	else if (word == "left" || word == "L")		input = Input::Left;
+	else if (word == "right" || word == "R")	input = Input::Right;
+	else return false;
+	return true;
+}
+
+static bool loadScript(const char *path, std::vector<ScriptedInput> &script) {
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		std::cerr << "Failed to open input script: " << path << std::endl;
+		return false;
+	}
+
+	ScriptedInput entry;
+	std::string word;
+	while (file >> entry.tick >> word) {
+		if (!parseDirection(word, entry.input)) {
+			std::cerr << "Unknown direction in input script: " << word << std::endl;
+			return false;
+		}
+		script.push_back(entry);
+	}
+	return true;
+}
+
+static Input wander(const GameState &state, Rng &rng) {
+	return Bot::steer(state.snake, state.food.getPosition(), state.occupancy, rng);
+}
+
+static int runBatch(int width, int height, long targetTicks, int arenas, int threads, uint64_t seed) {
+	BatchEngine engine(width, height, arenas, threads, seed);
+	Rng botRng(~seed);
+	std::vector<Input> actions(arenas, Input::None);
+
+	long ticks = 0;
+	long games = arenas;
+	int bestScore = 0;
+
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	while (ticks < targetTicks) {
+		for (int i = 0; i < arenas; ++i)
+			actions[i] = wander(engine.getState(i), botRng);
+
+		if (!engine.stepAll(actions))
+			return 1;
+		ticks += arenas;
+
+		for (int i = 0; i < arenas; ++i) {
+			if (!engine.isAlive(i)) {
+				bestScore = std::max(bestScore, engine.getScore(i));
+				engine.resetArena(i);
+				games++;
+			}
+		}
+	}
+
+	std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+	for (int i = 0; i < arenas; ++i)
+		bestScore = std::max(bestScore, engine.getScore(i));
+
+	std::cout << BGRN << "[Headless] " << arenas << " arenas of " << width << "x" << height << " on "
+		<< threads << " threads: " << ticks << " ticks, " << games << " games, best score " << bestScore
+		<< " in " << elapsed.count() << " s (" << static_cast<long>(ticks / elapsed.count()) << " ticks/s)"
+		<< RESET << std::endl;
+
+	return 0;
+}
+
+static int runReplay(const char *path) {
+	ReplayPlayer replay;
+	if (!replay.load(path))
+		return 1;
+
+	int width = replay.getWidth();
+	int height = replay.getHeight();
+	const std::vector<ReplayGame> &games = replay.getGames();
+
+	Rng rng(0);
+	OccupancyGrid occupancy(width, height);
+	std::vector<Snake> snakes;
+	std::vector<Food> foods;
+	GameManager::buildArena(width, height, replay.getSnakeCount(), replay.getFoodCount(), occupancy, rng, snakes, foods);
+	Snake &snake = snakes[0];
+	Food &food = foods[0];
+	GameState state {
+		width, height, snake, food, occupancy, rng,
+		false,
+		true,
+		false,
+		GameStateType::Playing,
+		0,
+		snakes,
+		foods
+	};
+
+	GameManager gameManager(&state);
+
+	long ticks = 0;
+	int mismatches = 0;
+
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	for (size_t i = 0; i < games.size(); ++i) {
+		const ReplayGame &game = games[i];
+
+		rng.seed(game.seed);
+		snake.respawn(rng);
+		food = Food(rng.getVec2(width - 1, height - 1), width, height, rng);
+		state.score = 0;
+		state.isRunning = true;
+		gameManager.clearInputBuffer();
+		gameManager.resetTick();
+		gameManager.populate();
+
+		size_t nextTurn = 0;
+		while (state.isRunning && gameManager.getTick() < game.ticks) {
+			while (nextTurn < game.events.size() && game.events[nextTurn].tick == gameManager.getTick()) {
+				gameManager.clearInputBuffer();
+				gameManager.bufferInput(game.events[nextTurn++].input);
+			}
+			gameManager.update();
+		}
+		ticks += gameManager.getTick();
+
+		bool finished = !state.isRunning;
+		if (gameManager.getTick() != game.ticks || state.score != game.score || finished != game.finished) {
+			std::cerr << BRED << "[Headless] Game " << i + 1 << " differs: " << gameManager.getTick() << " ticks, score "
+				<< state.score << " (recorded " << game.ticks << " ticks, score " << game.score << ")" << RESET << std::endl;
+			mismatches++;
+		}
+	}
+
+	std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+
+	std::cout << (mismatches ? BRED : BGRN) << "[Headless] Replay " << width << "x" << height << ": " << games.size()
+		<< " games, " << ticks << " ticks in " << elapsed.count() << " s ("
+		<< static_cast<long>(ticks / elapsed.count()) << " ticks/s), "
+		<< (mismatches ? std::to_string(mismatches) + " games differ" : "all games match") << RESET << std::endl;
+
+	return mismatches ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+	if (argc == 3 && !std::strcmp(argv[1], "--replay"))
+		return runReplay(argv[2]);
+
+	if (argc < 3) {
+		printUsage();
+		return 1;
+	}
+
+	int width = std::stoi(argv[1]);
+	int height = std::stoi(argv[2]);
+
+	if (width < 16 || height < 16) {
+		std::cerr << "Minimal arena width and height values are 16 units! Try running again with those or higher values!" << std::endl;
+		return 1;
+	}
+
+	if (width > MAX_ARENA_SIDE || height > MAX_ARENA_SIDE) {
+		std::cerr << "Maximal arena width and height values are " << MAX_ARENA_SIDE << " units!" << std::endl;
+		return 1;
+	}
+
+	long targetTicks = 1000000;
+	const char *scriptPath = nullptr;
+	const char *libPath = nullptr;
+	const char *recordPath = nullptr;
+	const char *tracePath = nullptr;
+	int batchArenas = 0;
+	int snakeCount = 1;
+	int foodCount = 1;
+	int threads = std::max(1u, std::thread::hardware_concurrency());
+	uint64_t seed = Rng::randomSeed();
+
+	for (int i = 3; i < argc; ++i) {
+		if (!std::strcmp(argv[i], "--ticks") && i + 1 < argc)
+			targetTicks = std::stol(argv[++i]);
+		else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc)
+			seed = std::stoull(argv[++i]);
+		else if (!std::strcmp(argv[i], "--script") && i + 1 < argc)
+			scriptPath = argv[++i];
+		else if (!std::strcmp(argv[i], "--lib") && i + 1 < argc)
+			libPath = argv[++i];
+		else if (!std::strcmp(argv[i], "--record") && i + 1 < argc)
+			recordPath = argv[++i];
+		else if (!std::strcmp(argv[i], "--trace") && i + 1 < argc)
+			tracePath = argv[++i];
+		else if (!std::strcmp(argv[i], "--snakes") && i + 1 < argc)
+			snakeCount = std::stoi(argv[++i]);
+		else if (!std::strcmp(argv[i], "--food") && i + 1 < argc)
+			foodCount = std::stoi(argv[++i]);
+		else if (!std::strcmp(argv[i], "--batch") && i + 1 < argc)
+			batchArenas = std::stoi(argv[++i]);
+		else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc)
+			threads = std::stoi(argv[++i]);
+		else {
+			printUsage();
+			return 1;
+		}
+	}
+
+	if (snakeCount < 1 || foodCount < 1 || snakeCount > MAX_SNAKES || foodCount > MAX_FOODS) {
+		std::cerr << "An arena holds 1 to " << MAX_SNAKES << " snakes and 1 to " << MAX_FOODS << " foods" << std::endl;
+		return 1;
+	}
+
+	std::cout << BYEL << "[Headless] Seed: " << seed << RESET << std::endl;
+
+	if (tracePath) {
+		Tracer::enable();
+		Tracer::setThreadName("main");
+	}
+
+	if (batchArenas > 0) {
+		if (scriptPath || libPath || recordPath || snakeCount > 1 || foodCount > 1) {
+			std::cerr << "--batch runs the bot only, without --script, --lib, --record, --snakes or --food" << std::endl;
+			return 1;
+		}
+		int result = runBatch(width, height, targetTicks, batchArenas, threads, seed);
+		if (tracePath)
+			Tracer::write(tracePath);
+		return result;
+	}
+
+	std::vector<ScriptedInput> script;
+	if (scriptPath && !loadScript(scriptPath, script))
+		return 1;
+
+	// Optional renderer, e.g. ./nibbler_null.so, to include plugin dispatch in the measurement
+	LibraryManager gfxLib;
+	if (libPath) {
+		if (!gfxLib.load(libPath))
+			return 1;
+		gfxLib.get()->init(width, height);
+	}
+
+	Rng rng(seed);
+	Rng botRng(~seed);
+	OccupancyGrid occupancy(width, height);
+	std::vector<Snake> snakes;
+	std::vector<Food> foods;
+	GameManager::buildArena(width, height, snakeCount, foodCount, occupancy, rng, snakes, foods);
+	Snake &snake = snakes[0];
+	Food &food = foods[0];
+	GameState state {
+		width, height, snake, food, occupancy, rng,
+		false,
+		true,
+		false,
+		GameStateType::Playing,
+		0,
+		snakes,
+		foods
+	};
+
+	std::unique_ptr<ReplayRecorder> recorder;
+	if (recordPath) {
+		recorder = std::make_unique<ReplayRecorder>(recordPath, width, height, snakeCount, foodCount);
+		if (!recorder->isOpen())
+			return 1;
+		recorder->beginGame(seed);
+	}
+
+	GameManager gameManager(&state);
+	gameManager.setRecorder(recorder.get());
+	gameManager.populate();
+
+	long ticks = 0;
+	long games = 1;
+	int bestScore = 0;
+	size_t nextScripted = 0;
+
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	while (ticks < targetTicks) {
+		if (scriptPath) {
+			while (nextScripted < script.size() && script[nextScripted].tick <= ticks)
+				gameManager.bufferInput(script[nextScripted++].input);
+		} else {
+			// Decide on the current head, not on whatever was queued ticks ago
+			gameManager.clearInputBuffer();
+			gameManager.bufferInput(wander(state, botRng));
+		}
+
+		gameManager.update();
+		ticks++;
+
+		if (gfxLib.get()) {
+			if (gfxLib.supports(GRAPHIC_CAP_CHANGES)) {
+				gfxLib.get()->applyChanges(gameManager.getChanges());
+				gameManager.clearChanges();
+			}
+			gfxLib.get()->render(state, 0.0f);
+			gfxLib.get()->present();
+		}
+
+		if (!state.isRunning) {
+			bestScore = std::max(bestScore, state.score);
+			if (recorder)
+				recorder->endGame(gameManager.getTick(), state.score, true);
+
+			rng.seed(seed + games);
+			snake.respawn(rng);
+			food = Food(rng.getVec2(width - 1, height - 1), width, height, rng);
+			state.score = 0;
+			state.isRunning = true;
+			gameManager.clearInputBuffer();
+			gameManager.resetTick();
+			gameManager.populate();
+			if (recorder)
+				recorder->beginGame(seed + games);
+			games++;
+		}
+	}
+	if (recorder)
+		recorder->endGame(gameManager.getTick(), state.score, false);
+
+	std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+	bestScore = std::max(bestScore, state.score);
+
+	std::cout << BGRN << "[Headless] " << width << "x" << height << ": " << ticks << " ticks, "
+		<< games << " games, best score " << bestScore << " in " << elapsed.count() << " s ("
+		<< static_cast<long>(ticks / elapsed.count()) << " ticks/s)" << RESET << std::endl;
+
+	if (tracePath)
+		Tracer::write(tracePath);
+
+	return 0;
+}
@@ -1,16 +1,27 @@
 #include "../incs/IGraphic.hpp"
 #include "../incs/Snake.hpp"
 #include "../incs/Food.hpp"
+#include "../incs/OccupancyGrid.hpp"
 #include "../incs/DataStructs.hpp"
 #include "../incs/GameManager.hpp"
 #include "../incs/LibraryManager.hpp"
-#include "../incs/Utils.hpp"
+#include "../incs/Rng.hpp"
+#include "../incs/Replay.hpp"
+#include "../incs/FrameStats.hpp"
+#include "../incs/Tracer.hpp"
+#include "../incs/SimulationThread.hpp"
+#include "../incs/FrameScheduler.hpp"
+#include "../incs/TickScheduler.hpp"
 #include "../incs/colors.h"
 #include <thread>
+#include <algorithm>
 #include <fcntl.h>
 #include <iostream>
 #include <ncurses.h>
 #include <array>
+#include <memory>
+#include <csignal>
+#include <cstring>
 #include <string_view>
 
 // Cleanup handler for ncurses when program exits
@@ -21,12 +32,23 @@ void cleanupNCurses() {
 	}
 }
 
+static void printUsage() {
+	std::cerr << BYEL << "Usage: ./nibbler <width> <height> [--seed N] [--record file | --replay file] [--stats file] [--trace file] [--threaded] [--tick-rate N] [--fps N] [--max-catch-up ms] [--turbo N] [--snakes N] [--food N] [--resident] [--no-prewarm] [--hot-reload]" << RESET << std::endl;
+}
+
+// SIGUSR1 asks for a frame stats dump; the main loop picks it up between frames
+static volatile sig_atomic_t g_statsRequested = 0;
+
+static void requestStatsDump(int) {
+	g_statsRequested = 1;
+}
+
 int main(int argc, char **argv) {
 	std::atexit(cleanupNCurses); // This might not be necessary after switching to an external, dynamically linked Ncurses, but we'll leave it just in case (legacy!)
 	
-	if (argc != 3)
+	if (argc < 3)
 	{
-		std::cerr << BYEL << "Usage: ./nibbler <width> <height>" << RESET << std::endl;
+		printUsage();
 		return 1;
 	}
 
@@ -39,6 +61,134 @@ int main(int argc, char **argv) {
 		return 1;
 	}
 
+	if (width > MAX_ARENA_SIDE || height > MAX_ARENA_SIDE)
+	{
+		std::cerr << "Maximal arena width and height values are " << MAX_ARENA_SIDE << " units!" << std::endl;
+		return 1;
+	}
+
+	uint64_t seed = Rng::randomSeed();
+	const char *recordPath = nullptr;
+	const char *replayPath = nullptr;
+	const char *statsPath = nullptr;
+	const char *tracePath = nullptr;
+	bool threaded = false;
+	bool resident = false;		// keep every graphics library loaded and switch without reloading
+	bool prewarm = true;		// otherwise open and warm up the others in the background
+	bool hotReload = false;		// swap in a graphics library rebuilt while the game runs
+	double tickRate = 10.0;		// Snake moves 10 times per second
+	double renderFps = 60.0;	// Frames are drawn at most this often, unless a key comes in
+	double maxCatchUpMs = 250.0;	// Most game time one frame may make up for after a stall
+	int turbo = 0;
+	int snakeCount = 1;		// the player plus bots
+	int foodCount = 1;
+	for (int i = 3; i < argc; ++i) {
+		if (!std::strcmp(argv[i], "--seed") && i + 1 < argc)
+			seed = std::stoull(argv[++i]);
+		else if (!std::strcmp(argv[i], "--record") && i + 1 < argc)
+			recordPath = argv[++i];
+		else if (!std::strcmp(argv[i], "--replay") && i + 1 < argc)
+			replayPath = argv[++i];
+		else if (!std::strcmp(argv[i], "--stats") && i + 1 < argc)
+			statsPath = argv[++i];
+		else if (!std::strcmp(argv[i], "--trace") && i + 1 < argc)
+			tracePath = argv[++i];
+		else if (!std::strcmp(argv[i], "--threaded"))
+			threaded = true;
+		else if (!std::strcmp(argv[i], "--resident"))
+			resident = true;
+		else if (!std::strcmp(argv[i], "--no-prewarm"))
+			prewarm = false;
+		else if (!std::strcmp(argv[i], "--hot-reload"))
+			hotReload = true;
+		else if (!std::strcmp(argv[i], "--tick-rate") && i + 1 < argc)
+			tickRate = std::stod(argv[++i]);
+		else if (!std::strcmp(argv[i], "--fps") && i + 1 < argc)
+			renderFps = std::stod(argv[++i]);
+		else if (!std::strcmp(argv[i], "--max-catch-up") && i + 1 < argc)
+			maxCatchUpMs = std::stod(argv[++i]);
+		else if (!std::strcmp(argv[i], "--turbo") && i + 1 < argc)
+			turbo = std::stoi(argv[++i]);
+		else if (!std::strcmp(argv[i], "--snakes") && i + 1 < argc)
+			snakeCount = std::stoi(argv[++i]);
+		else if (!std::strcmp(argv[i], "--food") && i + 1 < argc)
+			foodCount = std::stoi(argv[++i]);
+		else {
+			printUsage();
+			return 1;
+		}
+	}
+
+	// Written so that NaN fails too
+	if (!(tickRate > 0.0) || !(renderFps > 0.0)) {
+		std::cerr << "--tick-rate and --fps must be positive" << std::endl;
+		return 1;
+	}
+	// The schedulers turn it into a tick count and a nanosecond count, so it has to stay well inside both;
+	// written so that NaN fails too
+	const double MAX_CATCH_UP_MS = 60000.0;
+	if (!(maxCatchUpMs >= 0.0 && maxCatchUpMs <= MAX_CATCH_UP_MS)) {
+		std::cerr << "--max-catch-up must be between 0 and " << MAX_CATCH_UP_MS << " ms" << std::endl;
+		return 1;
+	}
+	if (turbo < 0 || (turbo > 0 && threaded)) {
+		std::cerr << "--turbo takes a positive tick count and can't be used with --threaded" << std::endl;
+		return 1;
+	}
+	if (snakeCount < 1 || foodCount < 1 || snakeCount > MAX_SNAKES || foodCount > MAX_FOODS) {
+		std::cerr << "An arena holds 1 to " << MAX_SNAKES << " snakes and 1 to " << MAX_FOODS << " foods" << std::endl;
+		return 1;
+	}
+
+	// Game n of a session plays with seed + n; a replay brings its own seeds and arena size
+	ReplayPlayer replay;
+	const std::vector<ReplayGame> &replayGames = replay.getGames();
+	if (replayPath) {
+		if (recordPath) {
+			std::cerr << "--record and --replay can't be used together" << std::endl;
+			return 1;
+		}
+		if (threaded) {
+			std::cerr << "--threaded can't be used with --replay" << std::endl;
+			return 1;
+		}
+		if (!replay.load(replayPath))
+			return 1;
+		if (replayGames.empty()) {
+			std::cerr << "Replay holds no games: " << replayPath << std::endl;
+			return 1;
+		}
+		width = replay.getWidth();
+		height = replay.getHeight();
+		snakeCount = replay.getSnakeCount();
+		foodCount = replay.getFoodCount();
+		seed = replayGames[0].seed;
+		std::cout << BYEL << "[Main] Replaying " << replayGames.size() << " games on " << width << "x" << height << RESET << std::endl;
+	} else
+		std::cout << BYEL << "[Main] Seed: " << seed << RESET << std::endl;
+
+	// Snapshots only carry the player and one food, which is all the threaded renderer gets to see
+	if (threaded && (snakeCount > 1 || foodCount > 1)) {
+		std::cerr << "--threaded can't be used with --snakes or --food" << std::endl;
+		return 1;
+	}
+	if (hotReload && resident) {
+		std::cerr << "--hot-reload can't be used with --resident" << std::endl;
+		return 1;
+	}
+
+	std::unique_ptr<ReplayRecorder> recorder;
+	if (recordPath) {
+		recorder = std::make_unique<ReplayRecorder>(recordPath, width, height, snakeCount, foodCount);
+		if (!recorder->isOpen())
+			return 1;
+	}
+
+	if (tracePath) {
+		Tracer::enable();
+		Tracer::setThreadName("main");
+	}
+
 	constexpr std::array<std::string_view, 3> libs = {
 		"./nibbler_ncurses.so",
 		"./nibbler_sdl.so",
@@ -47,52 +197,178 @@ int main(int argc, char **argv) {
 	int currentLib = 1;
 
 	LibraryManager gfxLib;
-	if (!gfxLib.load(libs[currentLib].data()))
+	if (hotReload && !gfxLib.enableHotReload())
 		return 1;
+	if (resident) {
+		if (!gfxLib.loadResident(libs, currentLib, width, height))
+			return 1;
+	} else {
+		if (!gfxLib.load(libs[currentLib].data()))
+			return 1;
 
-	gfxLib.get()->init(width, height);
+		// Plugins load their fonts, logos and textures in init()
+		{
+			TRACE_SCOPE("plugin_init");
+			gfxLib.get()->init(width, height);
+		}
+		// Meanwhile the others get ready on a worker thread, so a switch finds them already loaded
+		if (prewarm)
+			gfxLib.prewarm(libs, width, height);
+	}
 
-	Snake snake(width, height);
-	Food food(Utils::getRandomVec2(width - 1, height - 1), width, height);
+	// Everything random in the game draws from this one generator, so a seed replays the same spawns and food
+	Rng rng(seed);
+	OccupancyGrid occupancy(width, height);
+	std::vector<Snake> snakes;
+	std::vector<Food> foods;
+	GameManager::buildArena(width, height, snakeCount, foodCount, occupancy, rng, snakes, foods);
+	Snake &snake = snakes[0];
+	Food &food = foods[0];
 	GameState state {
-		width, height, snake, food,
+		width, height, snake, food, occupancy, rng,
 		false,
 		true,
 		false,
 		GameStateType::Menu,
-		0
+		0,
+		snakes,
+		foods
 	};
 
 	GameManager gameManager(&state);
+	gameManager.setRecorder(recorder.get());
+	gameManager.populate();
 
-	const double TARGET_FPS = 10.0;					// Snake moves 10 times per second
-	const double FRAME_TIME = 1.0 / TARGET_FPS; 	// 0.1 seconds per update
-	
-	auto lastTime = std::chrono::high_resolution_clock::now();
-	double accumulator = 0.0;
+	const double FRAME_TIME = 1.0 / tickRate;		// Seconds per update
+	const auto RENDER_INTERVAL = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		std::chrono::duration<double>(1.0 / renderFps));
+
+	// With --threaded the simulation ticks on its own thread and the renderer draws a private copy of the
+	// game, restored from the latest snapshot it published; the live state is only touched while it's stopped
+	std::unique_ptr<SimulationThread> simulation;
+	Rng viewRng(seed);
+	OccupancyGrid viewOccupancy(width, height);
+	Snake viewSnake(width, height, viewOccupancy, viewRng);
+	Food viewFood(food.getPosition(), width, height, viewRng);
+	GameState viewState {
+		width, height, viewSnake, viewFood, viewOccupancy, viewRng,
+		false,
+		true,
+		false,
+		GameStateType::Playing,
+		0,
+		std::span<Snake>(&viewSnake, 1),
+		std::span<Food>(&viewFood, 1)
+	};
+	GameManager viewManager(&viewState);
+	if (threaded)
+		simulation = std::make_unique<SimulationThread>(gameManager, state, FRAME_TIME, maxCatchUpMs / 1000.0);
+
+	size_t gameIndex = 0;
+	uint64_t gameSeed = seed;
+	size_t nextTurn = 0;
+
+	auto endReplayedGame = [&]() {
+		const ReplayGame &game = replayGames[gameIndex];
+		bool matches = game.ticks == gameManager.getTick() && game.score == state.score;
+		std::cout << (matches ? BGRN : BRED) << "[Replay] Game " << gameIndex + 1 << ": " << gameManager.getTick()
+			<< " ticks, score " << state.score << (matches ? " (matches the recording)" : " (recording differs)")
+			<< RESET << std::endl;
+	};
+
+	auto finishGame = [&]() {
+		if (recorder)
+			recorder->endGame(gameManager.getTick(), state.score, true);
+		if (replayPath)
+			endReplayedGame();
+		state.currentState = GameStateType::GameOver;
+		state.isRunning = true;
+	};
+
+	// Hands the backend what changed in the game it is about to draw, then starts collecting afresh.
+	// A backend that redraws everything anyway leaves the full-redraw flag up, which stops the game
+	// from recording cells at all
+	auto drawGame = [&](GameState &drawn, GameManager &source, float frameTime) {
+		if (!gfxLib.supports(GRAPHIC_CAP_CHANGES)) {
+			source.markFullRedraw();
+			gfxLib.get()->render(drawn, frameTime);
+			return;
+		}
+		gfxLib.get()->applyChanges(source.getChanges());
+		gfxLib.get()->render(drawn, frameTime);
+		source.clearChanges();
+	};
+	// The alpha is only worked out for backends that draw from it
+	auto setInterpolation = [&](auto alpha) {
+		if (gfxLib.supports(GRAPHIC_CAP_INTERPOLATION))
+			gfxLib.get()->setInterpolation(static_cast<float>(alpha()));
+	};
+
+	auto lastTime = std::chrono::steady_clock::now();
+	TickScheduler ticks(FRAME_TIME, maxCatchUpMs / 1000.0);
+	ticks.setTurbo(turbo);
+	bool sessionOver = false;
+
+	FrameStats stats;
+	FrameScheduler scheduler;
+	std::string statsOutput = statsPath ? statsPath : "nibbler_stats.json";
+	std::signal(SIGUSR1, requestStatsDump);
+
+	auto writeStats = [&]() {
+		stats.setTickCounters(simulation ? simulation->getTickCounters() : ticks.getCounters());
+		if (stats.write(statsOutput))
+			std::cout << BYEL << "[Main] Frame stats written to " << statsOutput << RESET << std::endl;
+	};
 
 	// MAIN GAME LOOP
-	while (state.isRunning) {
-		auto currentTime = std::chrono::high_resolution_clock::now();
+	// The simulation thread owns state.isRunning while it ticks, so the loop keeps its own exit flag
+	while (!sessionOver) {
+		auto currentTime = std::chrono::steady_clock::now();
 		std::chrono::duration<float> frameTime = currentTime - lastTime;
 		float deltaTime = frameTime.count();
 		lastTime = currentTime;
 		
+		stats.beginFrame();
 		Input input = gfxLib.get()->pollInput();
+		stats.lap(FramePhase::Poll);
 		
 		if (input == Input::Quit) {
-			state.isRunning = false;
+			if (simulation)
+				simulation->stop();
+			if (recorder)
+				recorder->endGame(gameManager.getTick(), state.score, false);
 			break;
 		}
 		
 		if (input >= Input::SwitchLib1 && input <= Input::SwitchLib3) {
 			int newLib = (int)input - 1;
 			if (newLib != currentLib) {
-				gfxLib.unload();
-				if (!gfxLib.load(libs[newLib].data())) return 1;
-				gfxLib.get()->init(width, height);
+				TRACE_SCOPE("lib_switch");
+				if (gfxLib.isResident())
+					gfxLib.activate(newLib);
+				else if (gfxLib.load(libs[newLib].data())) {
+					{
+						TRACE_SCOPE("plugin_init");
+						gfxLib.get()->init(width, height);
+					}
+					// Warm the one just unloaded again, for a switch back
+					if (prewarm)
+						gfxLib.prewarm(libs, width, height);
+				} else
+					newLib = currentLib;	// refused, the current library is still loaded
 				currentLib = newLib;
+				stats.lap(FramePhase::Switch);
+			} else
+				stats.skipLap();
+		}
+
+		// A rebuilt library is swapped in between two frames; the game state never notices
+		if (hotReload && gfxLib.reloadIfChanged()) {
+			{
+				TRACE_SCOPE("plugin_init");
+				gfxLib.get()->init(width, height);
 			}
+			stats.lap(FramePhase::Switch);
 		}
 		
 		// STATE MACHINE
@@ -100,7 +376,11 @@ int main(int argc, char **argv) {
 			case GameStateType::Menu:
 				if (input == Input::Enter) {
 					state.currentState = GameStateType::Playing;
-					accumulator = 0.0;
+					ticks.reset();
+					if (recorder)
+						recorder->beginGame(gameSeed);
+					if (simulation)
+						simulation->start();
 				}
 				gfxLib.get()->renderMenu(state, deltaTime);
 				break;
@@ -111,50 +391,131 @@ int main(int argc, char **argv) {
 					state.currentState = state.isPaused ? 
 						GameStateType::Paused : GameStateType::Playing;
 				}
+
+				if (simulation) {
+					if (state.isPaused)
+						simulation->stop();
+					else
+						gameManager.bufferInput(input, std::chrono::steady_clock::now());
+
+					if (simulation->hasFinished()) {
+						simulation->stop();
+						finishGame();
+					}
+					if (!simulation->isRunning()) {
+						setInterpolation([] { return 1.0f; });
+						drawGame(state, gameManager, deltaTime);
+						break;
+					}
+					if (simulation->acquireLatest())
+						viewManager.restore(simulation->latest());
+					setInterpolation([&] { return simulation->getInterpolation(std::chrono::steady_clock::now()); });
+					drawGame(viewState, viewManager, deltaTime);
+					break;
+				}
 				
-				accumulator += deltaTime;
-				gameManager.bufferInput(input);
+				ticks.advance(deltaTime);
+				if (!replayPath)
+					gameManager.bufferInput(input);
 				
-				while (accumulator >= FRAME_TIME) {
+				while (ticks.takeTick()) {
+					// On replay the recorded turns stand in for the keyboard, fed in on the tick they were applied
+					if (replayPath) {
+						const std::vector<ReplayEvent> &turns = replayGames[gameIndex].events;
+						while (nextTurn < turns.size() && turns[nextTurn].tick == gameManager.getTick()) {
+							gameManager.clearInputBuffer();
+							gameManager.bufferInput(turns[nextTurn++].input);
+						}
+					}
+
 					gameManager.update();
-					accumulator -= FRAME_TIME;
+					stats.lap(FramePhase::Update);
 					
-					if (!state.isRunning) {
-						state.currentState = GameStateType::GameOver;
-						state.isRunning = true;
+					bool replayFinished = replayPath && gameManager.getTick() >= replayGames[gameIndex].ticks;
+					if (!state.isRunning || replayFinished) {
+						finishGame();
 						break;
 					}
 				}
 				
-				gfxLib.get()->render(state, deltaTime);
+				// Drawn between the last tick and the next one, by how much of the next has gone by
+				setInterpolation([&] { return ticks.getAlpha(); });
+				drawGame(state, gameManager, deltaTime);
 				break;
 				
 			case GameStateType::Paused:
 				if (input == Input::Pause) {
 					state.isPaused = false;
 					state.currentState = GameStateType::Playing;
+					if (simulation)
+						simulation->start();
 				}
-				gfxLib.get()->render(state, 0.0f);
+				setInterpolation([&] { return simulation ? 1.0 : ticks.getAlpha(); });
+				drawGame(state, gameManager, 0.0f);
 				break;
 				
 			case GameStateType::GameOver:
 				if (input == Input::Enter) {
-					snake = Snake(width, height);
-					food = Food(Utils::getRandomVec2(width - 1, height - 1), width, height);
+					gameIndex++;
+					if (replayPath && gameIndex >= replayGames.size()) {
+						sessionOver = true;
+						break;
+					}
+					gameSeed = replayPath ? replayGames[gameIndex].seed : seed + gameIndex;
+					nextTurn = 0;
+
+					rng.seed(gameSeed);
+					snake.respawn(rng);
+					food = Food(rng.getVec2(width - 1, height - 1), width, height, rng);
 					state.score = 0;
 					state.gameOver = false;
 					state.isPaused = false;
-					accumulator = 0.0;
+					ticks.reset();
 					gameManager.clearInputBuffer();
+					gameManager.resetTick();
+					gameManager.populate();
 					
 					state.currentState = GameStateType::Menu;
 				}
 				gfxLib.get()->renderGameOver(state, deltaTime);
 				break;
 		}
+		if (sessionOver)
+			break;
+		stats.lap(FramePhase::Render);
+
+		gfxLib.get()->present();
+		stats.lap(FramePhase::Present);
 		
-		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		// Sleep until the next frame or tick is due, or until a key comes in
+		auto wakeAt = currentTime + RENDER_INTERVAL;
+		if (state.currentState == GameStateType::Playing && !simulation && !ticks.isTurbo())
+			wakeAt = std::min(wakeAt, currentTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+				std::chrono::duration<double>(ticks.getTimeToNextTick())));
+		scheduler.waitUntil(wakeAt, *gfxLib.get());
+		stats.lap(FramePhase::Sleep);
+		stats.endFrame();
+
+		if (g_statsRequested) {
+			g_statsRequested = 0;
+			writeStats();
+		}
+	}
+
+	// The goal is a switch that fits in one frame, which takes --resident
+	const LatencyHistogram &switches = stats.get(FramePhase::Switch);
+	if (switches.getCount() > 0) {
+		double frameMs = 1000.0 / renderFps;
+		double maxMs = switches.getMax() / 1e6;
+		std::cout << (maxMs <= frameMs ? BGRN : BYEL) << "[Main] " << switches.getCount() << " library switches"
+			<< (resident ? " (resident)" : prewarm ? " (pre-warmed)" : "") << ": mean " << switches.getMean() / 1e6 << " ms, max " << maxMs
+			<< " ms, frame budget " << frameMs << " ms" << RESET << std::endl;
 	}
+
+	if (statsPath)
+		writeStats();
+	if (tracePath && Tracer::write(tracePath))
+		std::cout << BYEL << "[Main] Trace written to " << tracePath << RESET << std::endl;
 	
 	return 0;
 }
\ No newline at end of file